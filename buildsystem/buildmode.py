@@ -74,7 +74,7 @@ def get_build_mode(options: Options) -> BuildMode:
 	if options.compiler == "clang":
 		linking_command_args.append("-no-pie")
 	linking_command_args.append("-lm")
-	#linking_command_args.append("-lpthread")
+	linking_command_args.append("-lpthread")
 	if options.sdl2_static:
 		linking_command_args.append("`sdl2-config --cflags`")
 		linking_command_args.append("-static")
@@ -0,0 +1,362 @@
+
+#include "bench.h"
+#include "objects.h"
+#include "mapgrid.h"
+#include "vision.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <SDL2/SDL.h>
+
+double seconds_since(uint64_t counter_begin)
+{
+	uint64_t counter_end = SDL_GetPerformanceCounter();
+	return (double)(counter_end - counter_begin) / (double)SDL_GetPerformanceFrequency();
+}
+
+char const* turn_phase_name(turn_phase_t phase)
+{
+	switch (phase)
+	{
+		case TURN_PHASE_AGING:   return "aging";
+		case TURN_PHASE_LAWS:    return "laws";
+		case TURN_PHASE_MOVES:   return "moves";
+		case TURN_PHASE_DEATHS:  return "deaths";
+		case TURN_PHASE_RELEASE: return "release";
+		case TURN_PHASE_VISION:  return "vision";
+		default:
+			assert(false); exit(EXIT_FAILURE);
+	}
+}
+
+double g_turn_phase_seconds_table[TURN_PHASE_NUMBER] = {0};
+
+void bench_obj_table(void)
+{
+	printf("Benchmark the global table of objects\n");
+
+	/* One tile per object so that the tile object lists do not get in the way. */
+	init_mg(1024, 1024);
+	int const tile_number = g_mg_rect.w * g_mg_rect.h;
+
+	int const round_number = 10;
+	int const round_obj_number = 100000;
+	oid_t* oid_arr = malloc(round_number * round_obj_number * sizeof(oid_t));
+	assert(oid_arr != NULL);
+	int oid_arr_len = 0;
+
+	for (int round = 0; round < round_number; round++)
+	{
+		uint64_t counter_begin = SDL_GetPerformanceCounter();
+
+		/* Create a round worth of objects, and then destroy half of them so that
+		 * the table gets more and more riddled with unused entries as it grows. */
+		int const round_begin = oid_arr_len;
+		for (int i = 0; i < round_obj_number; i++)
+		{
+			int const tile_index = oid_arr_len % tile_number;
+			tc_t tc = {tile_index % g_mg_rect.w, tile_index / g_mg_rect.w};
+			oid_arr[oid_arr_len++] = obj_create(OBJ_ROCK, tc_to_loc(tc), 1, 0);
+		}
+		for (int i = round_begin; i < oid_arr_len; i += 2)
+		{
+			obj_destroy(oid_arr[i]);
+			oid_arr[i] = OID_NULL;
+		}
+
+		double seconds = seconds_since(counter_begin);
+		int const op_number = round_obj_number + round_obj_number / 2;
+		printf("Round %2d: %7d objects, %6.2f M operations per second\n",
+			round, g_obj_count, (double)op_number / seconds / 1000000.0);
+	}
+
+	uint64_t counter_begin = SDL_GetPerformanceCounter();
+	int destroy_number = 0;
+	for (int i = 0; i < oid_arr_len; i++)
+	{
+		if (!oid_eq(oid_arr[i], OID_NULL))
+		{
+			obj_destroy(oid_arr[i]);
+			destroy_number++;
+		}
+	}
+	double seconds = seconds_since(counter_begin);
+	printf("Destroy the %d remaining objects: %6.2f M operations per second\n",
+		destroy_number, (double)destroy_number / seconds / 1000000.0);
+
+	free(oid_arr);
+}
+
+/* What `vision_compute` replaced, kept as the reference it must agree with. */
+static void vision_compute_full_rays(tc_t src_tc)
+{
+	for (int y = 0; y < g_mg_rect.h; y++)
+	for (int x = 0; x < g_mg_rect.w; x++)
+	{
+		g_mg_vision_arr[y * g_mg_rect.w + x] = 0;
+	}
+
+	for (int y = 0; y < g_mg_rect.h; y++)
+	for (int x = 0; x < g_mg_rect.w; x++)
+	{
+		tc_t tc = {x, y};
+		if (get_tile_vision(tc) != 0)
+		{
+			continue;
+		}
+
+		int vision = VISION_SRC;
+		bresenham_it_t it = line_bresenham_init(src_tc, tc);
+		while (line_bresenham_iter(&it))
+		{
+			tile_t* tile = get_tile(it.head);
+			uint8_t* tile_vision = &g_mg_vision_arr[it.head.y * g_mg_rect.w + it.head.x];
+			*tile_vision = max(*tile_vision, vision);
+			if (tc_eq(it.head, src_tc))
+			{
+				continue;
+			}
+			vision -= tile->vision_blocking_sum;
+			if (vision < 0)
+			{
+				vision = 0;
+			}
+		}
+	}
+}
+
+/* Computes the vision again with `vision_compute_full_rays` (adding the time it took
+ * to `seconds`) and returns the number of tiles on which it disagrees with the vision
+ * that was there (`vision_arr` being a buffer of the size of the map grid). */
+static int vision_mismatch_count(tc_t src_tc, int* vision_arr, double* seconds)
+{
+	int const tile_number = g_mg_rect.w * g_mg_rect.h;
+	for (int i = 0; i < tile_number; i++)
+	{
+		vision_arr[i] = g_mg_vision_arr[i];
+	}
+	uint64_t counter_begin = SDL_GetPerformanceCounter();
+	vision_compute_full_rays(src_tc);
+	*seconds += seconds_since(counter_begin);
+	int mismatch_count = 0;
+	for (int i = 0; i < tile_number; i++)
+	{
+		mismatch_count += vision_arr[i] != g_mg_vision_arr[i];
+	}
+	return mismatch_count;
+}
+
+/* Makes a map grid of the given size randomly filled with at most one object per tile
+ * (some tiles being left empty), and returns the objects (to be given to `bench_free_mg`). */
+static oid_t* bench_random_mg(int size, int* oid_arr_len)
+{
+	/* About the proportions of the generated maps, in percents. */
+	struct { obj_type_t type; int percents; } const fill_table[] = {
+		{OBJ_MOSS, 25}, {OBJ_LIQUID, 15}, {OBJ_GRASS, 12}, {OBJ_BUSH, 10},
+		{OBJ_TREE, 20}, {OBJ_ROCK, 8}};
+	int const fill_number = sizeof fill_table / sizeof fill_table[0];
+
+	init_mg(size, size);
+	int const tile_number = g_mg_rect.w * g_mg_rect.h;
+	oid_t* oid_arr = malloc(tile_number * sizeof(oid_t));
+	assert(oid_arr != NULL);
+	*oid_arr_len = 0;
+	for (int i = 0; i < tile_number; i++)
+	{
+		int percent = rand() % 100;
+		for (int j = 0; j < fill_number; j++)
+		{
+			if (percent < fill_table[j].percents)
+			{
+				tc_t tc = {i % g_mg_rect.w, i / g_mg_rect.w};
+				oid_arr[(*oid_arr_len)++] = obj_create(fill_table[j].type, tc_to_loc(tc), 1, 0);
+				break;
+			}
+			percent -= fill_table[j].percents;
+		}
+	}
+	return oid_arr;
+}
+
+static void bench_free_mg(oid_t* oid_arr, int oid_arr_len)
+{
+	for (int i = 0; i < oid_arr_len; i++)
+	{
+		obj_destroy(oid_arr[i]);
+	}
+	free(oid_arr);
+	free_mg();
+}
+
+void bench_vision(void)
+{
+	printf("Benchmark the vision\n");
+
+	int const size_table[] = {100, 250, 500, 1000};
+	for (int size_index = 0; size_index < (int)(sizeof size_table / sizeof size_table[0]);
+		size_index++)
+	{
+		int const size = size_table[size_index];
+		int oid_arr_len;
+		oid_t* oid_arr = bench_random_mg(size, &oid_arr_len);
+		int const tile_number = g_mg_rect.w * g_mg_rect.h;
+
+		int* vision_arr = malloc(tile_number * sizeof(int));
+		assert(vision_arr != NULL);
+		int const src_number = 100000 / size;
+		int const full_rays_src_number = max(2, 1600 / size);
+		double seconds = 0.0, full_rays_seconds = 0.0;
+		int mismatch_count = 0;
+		for (int i = 0; i < src_number; i++)
+		{
+			tc_t src_tc = {rand() % g_mg_rect.w, rand() % g_mg_rect.h};
+
+			uint64_t counter_begin = SDL_GetPerformanceCounter();
+			vision_compute(src_tc);
+			seconds += seconds_since(counter_begin);
+
+			if (i < full_rays_src_number)
+			{
+				mismatch_count += vision_mismatch_count(src_tc, vision_arr, &full_rays_seconds);
+			}
+		}
+		double const ms = seconds * 1000.0 / (double)src_number;
+		double const full_rays_ms = full_rays_seconds * 1000.0 / (double)full_rays_src_number;
+		printf("Map %4dx%-4d: %9.4f ms per vision (full rays %9.3f ms, %6.1f times faster), "
+			"%d mismatching tiles\n",
+			size, size, ms, full_rays_ms, full_rays_ms / ms, mismatch_count);
+
+		/* Then from the middle of the map, something appears on or disappears from
+		 * a tile that is seen between each computation. */
+		tc_t const src_tc = {g_mg_rect.w / 2, g_mg_rect.h / 2};
+		vision_compute(src_tc);
+		int const change_number = 2000;
+		oid_t change_oid = OID_NULL;
+		seconds = 0.0;
+		mismatch_count = 0;
+		for (int i = 0; i < change_number; i++)
+		{
+			if (oid_eq(change_oid, OID_NULL))
+			{
+				tc_t tc;
+				do
+				{
+					tc = (tc_t){src_tc.x + rand() % 13 - 6, src_tc.y + rand() % 13 - 6};
+				} while (get_tile_vision(tc) == 0);
+				change_oid = obj_create(OBJ_GRASS, tc_to_loc(tc), 1, 0);
+			}
+			else
+			{
+				obj_destroy(change_oid);
+				change_oid = OID_NULL;
+			}
+
+			uint64_t counter_begin = SDL_GetPerformanceCounter();
+			vision_compute(src_tc);
+			seconds += seconds_since(counter_begin);
+
+			if (i < full_rays_src_number)
+			{
+				double full_rays_seconds_ignored = 0.0;
+				mismatch_count +=
+					vision_mismatch_count(src_tc, vision_arr, &full_rays_seconds_ignored);
+			}
+		}
+		if (!oid_eq(change_oid, OID_NULL))
+		{
+			obj_destroy(change_oid);
+		}
+		double const change_ms = seconds * 1000.0 / (double)change_number;
+		printf("             %9.4f ms per vision after a change (%5.1f %% of the time), "
+			"%d mismatching tiles\n",
+			change_ms, change_ms / ms * 100.0, mismatch_count);
+
+		free(vision_arr);
+		bench_free_mg(oid_arr, oid_arr_len);
+	}
+}
+
+void bench_vision_observers(void)
+{
+	printf("Benchmark the vision of observers\n");
+
+	int const size = 500;
+	int oid_arr_len;
+	oid_t* oid_arr = bench_random_mg(size, &oid_arr_len);
+
+	/* Caterpillars on the tiles that nothing is on. */
+	int const observer_number = 5000;
+	vision_observer_t* observer_arr = malloc(observer_number * sizeof(vision_observer_t));
+	assert(observer_arr != NULL);
+	oid_t* caterpillar_oid_arr = malloc(observer_number * sizeof(oid_t));
+	assert(caterpillar_oid_arr != NULL);
+	for (int i = 0; i < observer_number; i++)
+	{
+		tc_t tc;
+		do
+		{
+			tc = (tc_t){rand() % g_mg_rect.w, rand() % g_mg_rect.h};
+		} while (get_tile(tc)->oid_da.len != 0);
+		caterpillar_oid_arr[i] = obj_create(OBJ_CATERPILLAR, tc_to_loc(tc), 1, 0);
+		observer_arr[i].src_tc = tc;
+	}
+
+	/* Each observer looks at a tile close enough to be seen. */
+	int const radius_table[] = {4, 8, 16};
+	int const radius_number = sizeof radius_table / sizeof radius_table[0];
+	for (int radius_index = 0; radius_index < radius_number; radius_index++)
+	{
+		int const radius = radius_table[radius_index];
+		for (int i = 0; i < observer_number; i++)
+		{
+			tc_t const src_tc = observer_arr[i].src_tc;
+			observer_arr[i].dst_tc = (tc_t){
+				max(0, min(g_mg_rect.w - 1, src_tc.x + rand() % (2 * radius + 1) - radius)),
+				max(0, min(g_mg_rect.h - 1, src_tc.y + rand() % (2 * radius + 1) - radius))};
+		}
+		int const round_number = 10;
+		int seeing_count = 0;
+		uint64_t counter_begin = SDL_GetPerformanceCounter();
+		for (int round = 0; round < round_number; round++)
+		{
+			vision_compute_observers(observer_arr, observer_number, radius);
+		}
+		double const seconds = seconds_since(counter_begin);
+		for (int i = 0; i < observer_number; i++)
+		{
+			seeing_count += observer_arr[i].vision > 0;
+		}
+		printf("Map %dx%d, %d observers, radius %2d: %8.1f observers per ms "
+			"(%d see what they look at)\n",
+			size, size, observer_number, radius,
+			(double)(observer_number * round_number) / (seconds * 1000.0), seeing_count);
+	}
+
+	/* Compared to computing the vision of the whole map from each observer, with which
+	 * the observers must agree if they see the whole map. */
+	int const full_number = 20;
+	int mismatch_count = 0;
+	double seconds = 0.0;
+	for (int i = 0; i < full_number; i++)
+	{
+		vision_observer_t* observer = &observer_arr[i];
+		observer->dst_tc = (tc_t){rand() % g_mg_rect.w, rand() % g_mg_rect.h};
+		vision_compute_observers(observer, 1, size);
+		uint64_t counter_begin = SDL_GetPerformanceCounter();
+		vision_compute(observer->src_tc);
+		seconds += seconds_since(counter_begin);
+		mismatch_count += get_tile_vision(observer->dst_tc) != observer->vision;
+	}
+	printf("Map %dx%d, whole map vision: %8.1f observers per ms, %d mismatching observers\n",
+		size, size, (double)full_number / (seconds * 1000.0), mismatch_count);
+
+	for (int i = 0; i < observer_number; i++)
+	{
+		obj_destroy(caterpillar_oid_arr[i]);
+	}
+	free(caterpillar_oid_arr);
+	free(observer_arr);
+	bench_free_mg(oid_arr, oid_arr_len);
+}
@@ -0,0 +1,47 @@
+
+#ifndef WHYCRYSTALS_HEADER_BENCH_
+#define WHYCRYSTALS_HEADER_BENCH_
+
+#include <stdint.h>
+
+/* Benchmarks, run from the command line (see `main`) instead of the game. */
+
+/* Time elapsed since `counter_begin` (obtained via `SDL_GetPerformanceCounter`),
+ * in seconds. */
+double seconds_since(uint64_t counter_begin);
+
+/* The phases of a turn, that are timed separately (see `perform_turn`). */
+enum turn_phase_t
+{
+	TURN_PHASE_AGING,
+	TURN_PHASE_LAWS,
+	TURN_PHASE_MOVES,
+	TURN_PHASE_DEATHS,
+	TURN_PHASE_RELEASE,
+	TURN_PHASE_VISION,
+
+	TURN_PHASE_NUMBER
+};
+typedef enum turn_phase_t turn_phase_t;
+
+char const* turn_phase_name(turn_phase_t phase);
+
+/* Time spent in each phase of all the turns performed so far, in seconds. */
+extern double g_turn_phase_seconds_table[TURN_PHASE_NUMBER];
+
+/* Creates and destroys a million objects, printing the throughput as the global
+ * table of all objects grows (which should remain about the same). */
+void bench_obj_table(void);
+
+/* Computes the vision from random tiles of randomly filled maps of growing sizes,
+ * comparing `vision_compute` with casting a full ray to every tile (which it must
+ * agree with) and printing how long both take, and then from a fixed tile with
+ * something changing on a seen tile each time. */
+void bench_vision(void);
+
+/* Computes the vision of thousands of observers on a randomly filled map, each looking at
+ * a tile near it, printing how many observers are computed per millisecond for a few
+ * radii, and then compares with computing the vision of the whole map for each. */
+void bench_vision_observers(void);
+
+#endif /* WHYCRYSTALS_HEADER_BENCH_ */
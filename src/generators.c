@@ -1,14 +1,15 @@
 
 #include "generators.h"
+#include "rng.h"
 #include <assert.h>
 
 /* Section `obj_gen_t`. */
 
 oid_t obj_generate(obj_gen_t* gen, loc_t loc)
 {
-	int life = gen->life_min + rand() % (gen->life_max - gen->life_min + 1);
+	int life = gen->life_min + rng_rand() % (gen->life_max - gen->life_min + 1);
 	material_id_t material_id =
-		rand() < RARE_MATERIAL_PROBABILITY_MAX ? gen->rare_material_id : gen->material_id;
+		rng_rand() < RARE_MATERIAL_PROBABILITY_MAX ? gen->rare_material_id : gen->material_id;
 	oid_t oid = obj_create(gen->obj_type, loc, life, material_id);
 	return oid;
 }
@@ -19,7 +20,7 @@ obj_gen_t obj_gen_generate(void)
 		OBJ_TREE, OBJ_BUSH, OBJ_ROCK, OBJ_GRASS, OBJ_MOSS,
 		OBJ_LIQUID,
 		OBJ_SLIME, OBJ_CATERPILLAR};
-	obj_type_t obj_type = obj_types[rand() % (sizeof obj_types / sizeof obj_types[0])];
+	obj_type_t obj_type = obj_types[rng_rand() % (sizeof obj_types / sizeof obj_types[0])];
 
 	material_type_t material_type = MATERIAL_HARD;
 	switch (obj_type)
@@ -47,10 +48,10 @@ obj_gen_t obj_gen_generate(void)
 
 	material_id_t material_id = rand_material(material_type);
 	material_id_t rare_material_id = rand_material(material_type);
-	int rare_material_probability = rand() % (RARE_MATERIAL_PROBABILITY_MAX / 5);
+	int rare_material_probability = rng_rand() % (RARE_MATERIAL_PROBABILITY_MAX / 5);
 
-	int life_min = 1 + rand() % 5;
-	int life_max = life_min + rand() % 5;
+	int life_min = 1 + rng_rand() % 5;
+	int life_max = life_min + rng_rand() % 5;
 
 	return (obj_gen_t){
 		.obj_type = obj_type,
@@ -72,7 +73,7 @@ biome_gen_t biome_gen_generate(void)
 		malloc(biome_gen.gen_number * sizeof biome_gen.gen_probabilities[0]);
 	for (int i = 0; i < biome_gen.gen_number; i++)
 	{
-		int probability = rand() % 100 + 1;
+		int probability = rng_rand() % 100 + 1;
 		biome_gen.probability_sum += probability;
 		biome_gen.gen_probabilities[i] = (gen_probabilities_t){
 			.gen = obj_gen_generate(),
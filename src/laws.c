@@ -1,226 +1,1745 @@
-
 #include "laws.h"
 #include "utils.h"
 #include "mapgrid.h"
+#include "bench.h"
+#include "rng.h"
+#include "vision.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <SDL2/SDL.h>
+
+/* Defined in `main.c`. */
+void obj_hits_obj(oid_t oid_attacker, oid_t oid_target);
+void obj_move(oid_t oid, tm_t move);
+
+bool g_law_double_buffered = false;
+
+/* Section dedicated to how the laws change the world, which is either done right away
+ * or recorded as intents in double-buffered mode (see `g_law_double_buffered`). */
 
-void law_crystal_healing_effect(oid_t oid)
+enum law_intent_type_t
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	if (obj->type == OBJ_CRYSTAL)
+	/* An object created by the law (nowhere) is to be placed at `loc`. */
+	LAW_INTENT_PLACE,
+	/* The life of the object is to change by `life_delta`. */
+	LAW_INTENT_LIFE,
+	LAW_INTENT_DESTROY,
+};
+typedef enum law_intent_type_t law_intent_type_t;
+
+struct law_intent_t
+{
+	law_intent_type_t type;
+	oid_t oid;
+	union
+	{
+		loc_t loc;
+		int life_delta;
+	};
+};
+typedef struct law_intent_t law_intent_t;
+
+struct law_intent_da_t
+{
+	law_intent_t* arr;
+	int len, cap;
+};
+typedef struct law_intent_da_t law_intent_da_t;
+
+/* Where the laws applied by the calling thread record their intents. */
+static _Thread_local law_intent_da_t* t_law_intent_da = NULL;
+
+static void law_intent_add(law_intent_t intent)
+{
+	assert(t_law_intent_da != NULL);
+	law_intent_da_t* da = t_law_intent_da;
+	DA_LENGTHEN(da->len += 1, da->cap, da->arr, law_intent_t);
+	da->arr[da->len-1] = intent;
+}
+
+static void law_set_life(oid_t oid, int life)
+{
+	if (g_law_double_buffered)
+	{
+		law_intent_add((law_intent_t){
+			.type = LAW_INTENT_LIFE, .oid = oid, .life_delta = life - obj_life(oid)});
+	}
+	else
+	{
+		obj_set_life(oid, life);
+	}
+}
+
+static oid_t law_create(obj_type_t type, loc_t loc, int max_life, material_id_t material_id)
+{
+	if (g_law_double_buffered)
+	{
+		/* It exists right away (so that other objects can be created inside it),
+		 * but it is not in the world until the merge. */
+		oid_t oid = obj_create(type, (loc_t){.type = LOC_NONE}, max_life, material_id);
+		law_intent_add((law_intent_t){.type = LAW_INTENT_PLACE, .oid = oid, .loc = loc});
+		return oid;
+	}
+	else
+	{
+		return obj_create(type, loc, max_life, material_id);
+	}
+}
+
+static void law_destroy(oid_t oid)
+{
+	if (g_law_double_buffered)
+	{
+		law_intent_add((law_intent_t){.type = LAW_INTENT_DESTROY, .oid = oid});
+	}
+	else
+	{
+		obj_destroy(oid);
+	}
+}
+
+enum law_move_outcome_t
+{
+	LAW_MOVE_BLOCKED,
+	/* The object hits `hit_oid` (see `obj_hits_obj`) instead of moving, or is blocked
+	 * if `hit_oid` has left the tile by the time the move is done. */
+	LAW_MOVE_HIT,
+	LAW_MOVE_DONE,
+};
+typedef enum law_move_outcome_t law_move_outcome_t;
+
+/* An object trying to move by a law, which is always done once all the laws are applied
+ * (in both modes) by `law_resolve_moves`. */
+struct law_move_t
+{
+	/* Index in the map grid of the tile it tries to move to. */
+	int dst_tile_index;
+	/* The priority of the call that asked for it (see `law_call_t`). */
+	uint64_t priority;
+	oid_t oid;
+	tm_t move;
+	int law_index;
+	/* The call that asked for it did nothing else, so it counts as acting in the profiling
+	 * counters only if the move is done (or hits something). Only the first move of
+	 * a call counts. */
+	bool counts_as_acting;
+	/* Set by `law_chunk_settle_moves`. */
+	law_move_outcome_t outcome;
+	oid_t hit_oid;
+};
+typedef struct law_move_t law_move_t;
+
+struct law_move_da_t
+{
+	law_move_t* arr;
+	int len, cap;
+};
+typedef struct law_move_da_t law_move_da_t;
+
+/* Where the laws applied by the calling thread record their moves,
+ * and the priority of the current call. */
+static _Thread_local law_move_da_t* t_law_move_da = NULL;
+static _Thread_local uint64_t t_law_call_priority;
+
+static void law_try_move(oid_t oid, tm_t move)
+{
+	assert(t_law_move_da != NULL);
+	tc_t const dst_tc = tc_add_tm(loc_to_tc(get_obj(oid)->loc), move);
+	if (get_tile(dst_tc) == NULL)
+	{
+		/* Nowhere to go. */
+		return;
+	}
+	law_move_da_t* da = t_law_move_da;
+	DA_LENGTHEN(da->len += 1, da->cap, da->arr, law_move_t);
+	da->arr[da->len-1] = (law_move_t){
+		.dst_tile_index = tile_index(dst_tc),
+		.priority = t_law_call_priority,
+		.oid = oid,
+		.move = move};
+}
+
+/* Section dedicated to what the objects perceive of what is farther than the tiles next
+ * to them, that a law cannot look at (other chunks may be changing there). It is computed
+ * once per turn before the laws are applied, for all the objects at once, and the laws
+ * only read it. */
+
+/* How far the caterpillars see the player from. */
+#define LAW_PERCEPTION_RADIUS 8
+
+/* Where the player was at the beginning of the turn. */
+static tc_t g_law_perception_player_tc;
+
+/* The caterpillars around the player looking at it, in the order of the map grid. */
+static vision_observer_t* g_law_observer_da = NULL;
+static int g_law_observer_da_len = 0, g_law_observer_da_cap = 0;
+
+static void law_perceive(void)
+{
+	g_law_observer_da_len = 0;
+	obj_t* player_obj = get_obj(g_player_oid);
+	if (player_obj == NULL || player_obj->loc.type != LOC_TILE)
+	{
+		return;
+	}
+	tc_t const player_tc = loc_to_tc(player_obj->loc);
+	g_law_perception_player_tc = player_tc;
+	for (int y = max(player_tc.y - LAW_PERCEPTION_RADIUS, 0);
+		y <= min(player_tc.y + LAW_PERCEPTION_RADIUS, g_mg_rect.h - 1); y++)
+	for (int x = max(player_tc.x - LAW_PERCEPTION_RADIUS, 0);
+		x <= min(player_tc.x + LAW_PERCEPTION_RADIUS, g_mg_rect.w - 1); x++)
 	{
-		for (int i = 0; i < 4; i++)
+		tc_t const tc = {x, y};
+		if (!tc_eq(tc, player_tc) &&
+			oid_da_contains_type(&get_tile(tc)->oid_da, OBJ_CATERPILLAR))
 		{
-			tm_t tm = TM_ONE_ALL[i];
-			tc_t neighbor_tc = tc_add_tm(loc_to_tc(obj->loc), tm);
-			tile_t* neighbor_tile = get_tile(neighbor_tc);
-			if (neighbor_tile == NULL)
-			{
-				continue;
-			}
-			for (int i = 0; i < neighbor_tile->oid_da.len; i++)
-			{
-				obj_t* obj = get_obj(neighbor_tile->oid_da.arr[i]);
-				if (obj != NULL)
-				{
-					if (obj->life < obj->max_life)
-					{
-						obj->life++;
-					}
-				}
-			}
+			DA_LENGTHEN(g_law_observer_da_len += 1, g_law_observer_da_cap,
+				g_law_observer_da, vision_observer_t);
+			g_law_observer_da[g_law_observer_da_len-1] =
+				(vision_observer_t){.src_tc = tc, .dst_tc = player_tc};
 		}
 	}
+	vision_compute_observers(g_law_observer_da, g_law_observer_da_len, LAW_PERCEPTION_RADIUS);
 }
 
-void law_old_age_effect(oid_t oid)
+/* How well a caterpillar that was on the given tile at the beginning of the turn
+ * sees the player (0 if it does not). */
+static int law_player_vision(tc_t tc)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	if (obj->type == OBJ_SLIME || obj->type == OBJ_CATERPILLAR)
+	int begin = 0, end = g_law_observer_da_len;
+	while (begin < end)
 	{
-		if (obj->age > 100 && rand() % 5 == 0)
+		int const middle = (begin + end) / 2;
+		tc_t const middle_tc = g_law_observer_da[middle].src_tc;
+		if (tc_eq(middle_tc, tc))
+		{
+			return g_law_observer_da[middle].vision;
+		}
+		else if (middle_tc.y < tc.y || (middle_tc.y == tc.y && middle_tc.x < tc.x))
+		{
+			begin = middle + 1;
+		}
+		else
 		{
-			obj->life--;
+			end = middle;
 		}
 	}
+	return 0;
 }
 
-void law_slime_action(oid_t oid)
+/* Section dedicated to the laws. */
+
+/* In how many turns (at least 1) a chance of 1 in `n` that is tried every turn succeeds,
+ * so that a law can ask to be applied when that happens instead of trying every turn. */
+static int turns_until_one_in(int n)
+{
+	int turns = 1;
+	while (rng_rand() % n != 0)
+	{
+		turns++;
+	}
+	return turns;
+}
+
+int law_crystal_healing_effect(oid_t oid)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
-	if (obj->type == OBJ_SLIME)
+	assert(obj_type(oid) == OBJ_CRYSTAL);
+	bool healed = false;
+	for (int i = 0; i < 4; i++)
 	{
-		if (obj->age > 0 && obj->age % 50 == 0)
+		tm_t tm = TM_ONE_ALL[i];
+		tc_t neighbor_tc = tc_add_tm(loc_to_tc(obj->loc), tm);
+		tile_t* neighbor_tile = get_tile(neighbor_tc);
+		if (neighbor_tile == NULL)
 		{
-			oid_t oid_egg = obj_create(OBJ_EGG, obj->loc, 1, rand_material(MATERIAL_HARD));
-			obj_create(OBJ_SLIME, inside_obj_loc(oid_egg), obj->max_life, obj->max_life);
+			continue;
 		}
-		else
+		for (int i = 0; i < neighbor_tile->oid_da.len; i++)
 		{
-			if (obj->loc.type == LOC_TILE && rand() % 3 == 0)
+			oid_t neighbor_oid = neighbor_tile->oid_da.arr[i];
+			if (obj_life(neighbor_oid) < obj_max_life(neighbor_oid))
 			{
-				obj_try_move(oid, rand_tm_one());
+				law_set_life(neighbor_oid, obj_life(neighbor_oid) + 1);
+				healed = true;
 			}
 		}
 	}
+	/* Nothing to heal until something changes around. */
+	return healed ? 1 : LAW_NEVER_AGAIN;
 }
 
-void law_egg_hatching(oid_t oid)
+int law_old_age_effect(oid_t oid)
+{
+	assert(obj_type(oid) == OBJ_SLIME || obj_type(oid) == OBJ_CATERPILLAR);
+	if (obj_age(oid) > 100)
+	{
+		law_set_life(oid, obj_life(oid) - 1);
+	}
+	return turns_until_one_in(5);
+}
+
+int law_slime_breeding(oid_t oid)
+{
+	obj_t* obj = get_obj(oid);
+	assert(obj != NULL);
+	assert(obj_type(oid) == OBJ_SLIME);
+	oid_t oid_egg = law_create(OBJ_EGG, obj->loc, 1, rand_material(MATERIAL_HARD));
+	law_create(OBJ_SLIME, inside_obj_loc(oid_egg), obj_max_life(oid), obj_max_life(oid));
+	return 50;
+}
+
+int law_slime_moving(oid_t oid)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
-	if (obj->type == OBJ_EGG)
+	assert(obj_type(oid) == OBJ_SLIME);
+	if (obj->loc.type != LOC_TILE)
 	{
-		if (obj->age >= 45 && rand() % 10 == 0)
-		{
-			obj_destroy(oid);
-		}
+		/* Not going anywhere until it gets out. */
+		return LAW_NEVER_AGAIN;
+	}
+	if (rng_rand() % 3 == 0)
+	{
+		law_try_move(oid, rand_tm_one());
+	}
+	return 1;
+}
+
+int law_egg_hatching(oid_t oid)
+{
+	assert(obj_type(oid) == OBJ_EGG);
+	if (obj_age(oid) >= 45)
+	{
+		law_destroy(oid);
+		return LAW_NEVER_AGAIN;
 	}
+	return turns_until_one_in(10);
+}
+
+int law_caterpillar_breeding(oid_t oid)
+{
+	obj_t* obj = get_obj(oid);
+	assert(obj != NULL);
+	assert(obj_type(oid) == OBJ_CATERPILLAR);
+	law_create(OBJ_CATERPILLAR, obj->loc, obj_max_life(oid), obj_material_id(oid));
+	return 50;
 }
 
-void law_caterpillar_action(oid_t oid)
+int law_caterpillar_moving(oid_t oid)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
-	if (obj->type == OBJ_CATERPILLAR)
+	assert(obj_type(oid) == OBJ_CATERPILLAR);
+	if (obj->loc.type != LOC_TILE)
 	{
-		if (obj->age > 0 && obj->age % 50 == 0)
-		{
-			obj_create(OBJ_CATERPILLAR, obj->loc, obj->max_life, obj->material_id);
-		}
-		else
-		{
-			if (obj->loc.type == LOC_TILE)
-			{
-				for (int i = 0; i < 4; i++)
-				{
-					tm_t tm = TM_ONE_ALL[i];
-					tc_t dst_tc = tc_add_tm(loc_to_tc(obj->loc), tm);
-					tile_t* dst_tile = get_tile(dst_tc);
-					if (dst_tile == NULL)
-					{
-						continue;
-					}
-					if (oid_da_contains_type(&dst_tile->oid_da, OBJ_PLAYER))
-					{
-						obj_try_move(oid, tm);
-						goto caterpillar_done_moving;
-					}
-				}
-				obj_try_move(oid, rand_tm_one());
-				caterpillar_done_moving:;
-			}
-		}
+		/* Not going anywhere until it gets out. */
+		return LAW_NEVER_AGAIN;
+	}
+	tc_t const tc = loc_to_tc(obj->loc);
+	if (law_player_vision(tc) > 0)
+	{
+		/* Goes for the player it sees, along the axis it is the farthest on. */
+		tm_t const diff = tc_diff_as_tm(tc, g_law_perception_player_tc);
+		tm_t const tm = abs(diff.x) >= abs(diff.y) ?
+			(tm_t){diff.x > 0 ? 1 : -1, 0} : (tm_t){0, diff.y > 0 ? 1 : -1};
+		law_try_move(oid, tm);
+		return 1;
 	}
+	law_try_move(oid, rand_tm_one());
+	return 1;
 }
 
-void law_tree_action(oid_t oid)
+int law_tree_action(oid_t oid)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
-	if (obj->type == OBJ_TREE)
+	assert(obj_type(oid) == OBJ_TREE);
+	if (obj->loc.type == LOC_TILE && obj_age(oid) >= 45)
 	{
-		if (obj->loc.type == LOC_TILE && obj->age >= 45 && rand() % 40 == 0)
+		tc_t seed_tc = tc_add_tm(loc_to_tc(obj->loc), rand_tm_one());
+		tile_t* seed_tile = get_tile(seed_tc);
+		if (seed_tile != NULL)
 		{
-			tc_t seed_tc = tc_add_tm(loc_to_tc(obj->loc), rand_tm_one());
-			tile_t* seed_tile = get_tile(seed_tc);
-			if (seed_tile != NULL)
+			if (seed_tile->blocking_obj_count == 0)
 			{
-				bool seed_tile_blocked =
-					oid_da_contains_obj_f(&get_tile(seed_tc)->oid_da, obj_is_blocking);
-				if (!seed_tile_blocked)
-				{
-					obj_create(OBJ_SEED, tc_to_loc(seed_tc),
-						1, rand_material(MATERIAL_VEGETAL));
-				}
+				law_create(OBJ_SEED, tc_to_loc(seed_tc),
+					1, rand_material(MATERIAL_VEGETAL));
 			}
 		}
 	}
+	return turns_until_one_in(40);
 }
 
-void law_seed_growing(oid_t oid)
+int law_seed_growing(oid_t oid)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
-	if (obj->type == OBJ_SEED)
+	assert(obj_type(oid) == OBJ_SEED);
+	if (obj->loc.type == LOC_TILE && obj_age(oid) >= 45)
 	{
-		if (obj->loc.type == LOC_TILE && obj->age >= 45 && rand() % 10 == 0)
+		if (get_tile(loc_to_tc(obj->loc))->blocking_obj_count == 0)
 		{
-			bool tile_blocked =
-				oid_da_contains_obj_f(&get_tile(loc_to_tc(obj->loc))->oid_da, obj_is_blocking);
-			if (!tile_blocked)
-			{
-				obj_create(OBJ_TREE, obj->loc, 7, rand_material(MATERIAL_VEGETAL));
-				obj_destroy(oid);
-			}
+			law_create(OBJ_TREE, obj->loc, 7, rand_material(MATERIAL_VEGETAL));
+			law_destroy(oid);
+			return LAW_NEVER_AGAIN;
 		}
 	}
+	return turns_until_one_in(10);
 }
 
 law_t* g_law_da = NULL;
 int g_law_da_len = 0, g_law_da_cap = 0;
 
+/* Indices in `g_law_da` of the laws that apply to some object type,
+ * in the order of their registration. */
+struct law_index_da_t
+{
+	int* arr;
+	int len, cap;
+};
+typedef struct law_index_da_t law_index_da_t;
+
+/* For each object type, the laws to apply to its objects every turn, so that objects
+ * are only ever given to the laws that apply to them. Filled by `register_law`. */
+static law_index_da_t g_law_dispatch_table[OBJ_TYPE_NUMBER];
+/* For each object type, the scheduled laws that apply to its objects. */
+static law_index_da_t g_law_scheduled_table[OBJ_TYPE_NUMBER];
+/* For each object type, how many objects may be created by the laws applied every turn
+ * to one of its objects, at most. */
+static int g_law_max_created_obj_number_table[OBJ_TYPE_NUMBER];
+/* The types of the objects that some laws apply to. */
+static obj_type_set_t g_law_obj_type_set = 0;
+
 void register_law(law_t law)
 {
+	assert(law.obj_type_set != 0);
+	assert(!law.is_scheduled || law.first_age >= 1
+		/* Objects are not given to laws in the turn they are created. */);
 	DA_LENGTHEN(g_law_da_len += 1, g_law_da_cap, g_law_da, law_t);
 	g_law_da[g_law_da_len-1] = law;
+	g_law_obj_type_set |= law.obj_type_set;
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		if (law.obj_type_set & OBJ_TYPE_SET(type))
+		{
+			law_index_da_t* da = law.is_scheduled ?
+				&g_law_scheduled_table[type] : &g_law_dispatch_table[type];
+			DA_LENGTHEN(da->len += 1, da->cap, da->arr, int);
+			da->arr[da->len-1] = g_law_da_len-1;
+			if (!law.is_scheduled)
+			{
+				g_law_max_created_obj_number_table[type] += law.max_created_obj_number;
+			}
+		}
+	}
+	if (law.is_scheduled)
+	{
+		/* The new objects of these types will have to be scheduled for this law. */
+		g_obj_recorded_creation_type_set |= law.obj_type_set;
+	}
+	else
+	{
+		/* The objects of these types have to be awake for this law to see them. */
+		g_obj_wakeable_type_set |= law.obj_type_set;
+	}
 	printf("Registered law %s\n", law.name);
 }
 
 void register_laws(void)
 {
-	#define REGISTER_LAW_FUNCTION(function_name_) \
+	#define REGISTER_LAW_FUNCTION(function_name_, obj_type_set_, max_created_obj_number_) \
 		register_law((law_t){ \
 			.name = #function_name_, \
-			.function = function_name_})
-	REGISTER_LAW_FUNCTION(law_crystal_healing_effect);
-	REGISTER_LAW_FUNCTION(law_old_age_effect);
-	REGISTER_LAW_FUNCTION(law_slime_action);
-	REGISTER_LAW_FUNCTION(law_egg_hatching);
-	REGISTER_LAW_FUNCTION(law_caterpillar_action);
-	REGISTER_LAW_FUNCTION(law_tree_action);
-	REGISTER_LAW_FUNCTION(law_seed_growing);
+			.function = function_name_, \
+			.obj_type_set = obj_type_set_, \
+			.max_created_obj_number = max_created_obj_number_})
+	#define REGISTER_SCHEDULED_LAW_FUNCTION(function_name_, obj_type_set_, \
+		max_created_obj_number_, first_age_) \
+		register_law((law_t){ \
+			.name = #function_name_, \
+			.function = function_name_, \
+			.obj_type_set = obj_type_set_, \
+			.max_created_obj_number = max_created_obj_number_, \
+			.is_scheduled = true, \
+			.first_age = first_age_})
+	/* The laws that have a chance to do something every turn past some age are first
+	 * applied one turn before that age, to schedule the turn where the chance succeeds. */
+	REGISTER_LAW_FUNCTION(law_crystal_healing_effect, OBJ_TYPE_SET(OBJ_CRYSTAL), 0);
+	REGISTER_SCHEDULED_LAW_FUNCTION(law_old_age_effect,
+		OBJ_TYPE_SET(OBJ_SLIME) | OBJ_TYPE_SET(OBJ_CATERPILLAR), 0, 100);
+	REGISTER_SCHEDULED_LAW_FUNCTION(law_slime_breeding, OBJ_TYPE_SET(OBJ_SLIME), 2, 50);
+	REGISTER_LAW_FUNCTION(law_slime_moving, OBJ_TYPE_SET(OBJ_SLIME), 0);
+	REGISTER_SCHEDULED_LAW_FUNCTION(law_egg_hatching, OBJ_TYPE_SET(OBJ_EGG), 0, 44);
+	REGISTER_SCHEDULED_LAW_FUNCTION(law_caterpillar_breeding,
+		OBJ_TYPE_SET(OBJ_CATERPILLAR), 1, 50);
+	REGISTER_LAW_FUNCTION(law_caterpillar_moving, OBJ_TYPE_SET(OBJ_CATERPILLAR), 0);
+	REGISTER_SCHEDULED_LAW_FUNCTION(law_tree_action, OBJ_TYPE_SET(OBJ_TREE), 1, 44);
+	REGISTER_SCHEDULED_LAW_FUNCTION(law_seed_growing, OBJ_TYPE_SET(OBJ_SEED), 1, 44);
 	#undef REGISTER_LAW_FUNCTION
+	#undef REGISTER_SCHEDULED_LAW_FUNCTION
 }
 
-void apply_laws(void)
+/* Section dedicated to applying the laws, which is done by several threads at once.
+ * The map is split into square chunks, colored in a 2 by 2 checkerboard pattern, and
+ * the chunks of each color are processed concurrently, one color after the other.
+ * As a law only touches the tiles next to its object, two chunks of the same color
+ * (that are at least a whole chunk apart) never touch the same tile or object.
+ * Random numbers are drawn from streams keyed by the object and every chunk creates
+ * objects in its own reserved entries, so the outcome does not depend on the number
+ * of threads. */
+
+#define LAW_CHUNK_SIDE 16
+
+/* An application of a scheduled law to an object, due in some turn. */
+struct law_event_t
 {
-	oid_t oid = OID_NULL;
-	while (oid_iter(&oid))
+	uint64_t turn;
+	oid_t oid;
+	int law_index;
+};
+typedef struct law_event_t law_event_t;
+
+struct law_event_da_t
+{
+	law_event_t* arr;
+	int len, cap;
+};
+typedef struct law_event_da_t law_event_da_t;
+
+static void law_event_da_add(law_event_da_t* da, law_event_t event)
+{
+	DA_LENGTHEN(da->len += 1, da->cap, da->arr, law_event_t);
+	da->arr[da->len-1] = event;
+}
+
+/* A call to a law that recorded intents in double-buffered mode. */
+struct law_call_t
+{
+	/* The calls are merged in the order of their priorities, which are derived from the keys
+	 * of their random number streams (so that it does not depend on where the objects are
+	 * in the table of objects). */
+	uint64_t priority;
+	oid_t oid;
+	int law_index;
+	/* What the law returned. */
+	int turns;
+	/* Its intents, in the `intent_da` of the chunk where it was made. */
+	int intent_begin, intent_len;
+	law_intent_t const* intent_arr;
+	/* One of the objects it created could not be placed (see `law_merge_intents`). */
+	bool failed;
+};
+typedef struct law_call_t law_call_t;
+
+struct law_call_da_t
+{
+	law_call_t* arr;
+	int len, cap;
+};
+typedef struct law_call_da_t law_call_da_t;
+
+/* The objects in a chunk to apply the laws to (in the order of their indices),
+ * listed before any law is applied in the turn. */
+struct law_chunk_t
+{
+	/* The awake objects, to apply the laws that are not scheduled to. */
+	oid_t* oid_arr;
+	int oid_len, oid_cap;
+	/* The events due this turn for the objects that were in the chunk when listed. */
+	law_event_da_t due_event_da;
+	/* The events scheduled by the laws applied in the chunk, that are put in the wheel
+	 * once all the chunks of the color are done (in a fixed order). */
+	law_event_da_t scheduled_event_da;
+	/* How many objects may be created by the laws applied in the chunk, at most. */
+	int creation_bound;
+	obj_reservation_t reservation;
+	/* The profiling counters of the laws (indexed like `g_law_da`) for the calls made in
+	 * the chunk, added to the counters of the laws once all the chunks of the color are done
+	 * (so that the threads do not have to share them). */
+	law_stats_t* law_stats_arr;
+	/* In double-buffered mode, the intents recorded by the laws applied in the chunk
+	 * and the calls that recorded them, for the merge. */
+	law_intent_da_t intent_da;
+	law_call_da_t call_da;
+	/* The moves asked for by the laws applied in the chunk, and the moves to the tiles
+	 * of the chunk (asked for in the chunk or in the chunks around it),
+	 * see `law_resolve_moves`. */
+	law_move_da_t move_da;
+	law_move_da_t dst_move_da;
+	/* The chunk is far from the player, so the laws leave its objects alone
+	 * (see `g_law_lod_radius`). */
+	bool is_far;
+	/* When the chunk got far, the number of its objects of each type, and the log growth
+	 * of each type (see `g_law_lod_log_growth_table`). */
+	int far_count_table[OBJ_TYPE_NUMBER];
+	double far_log_growth_table[OBJ_TYPE_NUMBER];
+	/* The events that came due while the chunk was far, for when it gets near again. */
+	law_event_da_t parked_event_da;
+};
+typedef struct law_chunk_t law_chunk_t;
+
+static law_chunk_t* g_law_chunk_arr = NULL;
+static int g_law_chunk_w = 0, g_law_chunk_h = 0;
+/* Number of laws that the `law_stats_arr`s of the chunks have room for. */
+static int g_law_chunk_law_number = 0;
+
+/* Number of times the laws were applied (before the current application), it keys
+ * the random numbers drawn by the laws (with the object and the law) so that they are
+ * different every turn, and it is the turn that the events are scheduled for. */
+static uint64_t g_law_turn_number = 0;
+/* The key that the keys of the random number streams of the laws derive from
+ * in the current turn. */
+static uint64_t g_law_turn_rng_key;
+
+int g_law_thread_number = 1;
+int g_law_lod_radius = 0;
+bool g_law_lod_center_is_fixed = false;
+tc_t g_law_lod_center_tc;
+
+/* The events are in a timer wheel, the event due in turn `t` being in the slot
+ * `t % LAW_WHEEL_SIZE`. The events due in a later round of the wheel (more than
+ * `LAW_WHEEL_SIZE` turns ahead) just stay in their slot until their turn comes.
+ * Only the slot of the current turn is looked at, so an object costs nothing in the turns
+ * where no event is due for it (if no law applies to it every turn). */
+#define LAW_WHEEL_SIZE 64
+static law_event_da_t g_law_wheel[LAW_WHEEL_SIZE];
+
+static void law_schedule(law_event_t event)
+{
+	assert(event.turn >= g_law_turn_number);
+	law_event_da_add(&g_law_wheel[event.turn % LAW_WHEEL_SIZE], event);
+}
+
+/* Schedules the first application of the scheduled laws to a new object. */
+static void law_schedule_new_obj(oid_t oid)
+{
+	law_index_da_t const* da = &g_law_scheduled_table[obj_type(oid)];
+	for (int i = 0; i < da->len; i++)
+	{
+		int const turns_left = g_law_da[da->arr[i]].first_age - obj_age(oid);
+		law_schedule((law_event_t){
+			.turn = g_law_turn_number + max(turns_left, 0),
+			.oid = oid,
+			.law_index = da->arr[i]});
+	}
+}
+
+static int compare_oid_indices(void const* a, void const* b)
+{
+	int const index_a = ((oid_t const*)a)->index, index_b = ((oid_t const*)b)->index;
+	return (index_a > index_b) - (index_a < index_b);
+}
+
+static law_chunk_t* law_chunk_of_obj(oid_t oid)
+{
+	tc_t const tc = loc_to_tc(get_obj(oid)->loc);
+	int const chunk_x = (tc.x - g_mg_rect.x) / LAW_CHUNK_SIDE;
+	int const chunk_y = (tc.y - g_mg_rect.y) / LAW_CHUNK_SIDE;
+	return &g_law_chunk_arr[chunk_y * g_law_chunk_w + chunk_x];
+}
+
+/* Section dedicated to the level of detail of the simulation (see `g_law_lod_radius`).
+ * When a chunk gets far from the player, the number of its objects of each type is
+ * recorded. While it is far, its populations are assumed to grow like the populations
+ * near the player do. When it gets near again, objects are cloned or destroyed so that
+ * its populations match what they would have become. */
+
+/* For each type, the sum over the turns of the log of how much its population near
+ * the player grew in the turn. */
+static double g_law_lod_log_growth_table[OBJ_TYPE_NUMBER];
+/* For each type, the number of objects that the far chunks had when they got far. */
+static int g_law_lod_far_count_table[OBJ_TYPE_NUMBER];
+/* For each type, the number of objects near the player after the previous update. */
+static int g_law_lod_prev_near_count_table[OBJ_TYPE_NUMBER];
+
+/* All the objects of a chunk, subobjects included, listed by `law_chunk_list_all_objs`. */
+static oid_t* g_law_lod_oid_da = NULL;
+static int g_law_lod_oid_da_len = 0, g_law_lod_oid_da_cap = 0;
+
+static tc_rect_t law_chunk_rect(int chunk_index)
+{
+	int const x = g_mg_rect.x + (chunk_index % g_law_chunk_w) * LAW_CHUNK_SIDE;
+	int const y = g_mg_rect.y + (chunk_index / g_law_chunk_w) * LAW_CHUNK_SIDE;
+	return (tc_rect_t){x, y,
+		min(LAW_CHUNK_SIDE, g_mg_rect.x + g_mg_rect.w - x),
+		min(LAW_CHUNK_SIDE, g_mg_rect.y + g_mg_rect.h - y)};
+}
+
+static bool law_chunk_is_far(int chunk_index, tc_t center_tc)
+{
+	tc_rect_t const rect = law_chunk_rect(chunk_index);
+	int const dx = max(max(rect.x - center_tc.x, center_tc.x - (rect.x + rect.w - 1)), 0);
+	int const dy = max(max(rect.y - center_tc.y, center_tc.y - (rect.y + rect.h - 1)), 0);
+	return max(dx, dy) > g_law_lod_radius;
+}
+
+static void law_lod_oid_da_add_rec(oid_t oid)
+{
+	DA_LENGTHEN(g_law_lod_oid_da_len += 1, g_law_lod_oid_da_cap, g_law_lod_oid_da, oid_t);
+	g_law_lod_oid_da[g_law_lod_oid_da_len-1] = oid;
+	obj_t* obj = get_obj(oid);
+	for (int i = 0; i < obj->attached_da.len; i++)
 	{
-		obj_t* obj = get_obj(oid);
-		obj->age++;
+		law_lod_oid_da_add_rec(obj->attached_da.arr[i]);
+	}
+}
 
-		for (int i = 0; i < g_law_da_len; i++)
+static void law_chunk_list_all_objs(int chunk_index)
+{
+	g_law_lod_oid_da_len = 0;
+	tc_rect_t const rect = law_chunk_rect(chunk_index);
+	for (int y = rect.y; y < rect.y + rect.h; y++)
+	for (int x = rect.x; x < rect.x + rect.w; x++)
+	{
+		tile_t* tile = get_tile((tc_t){x, y});
+		for (int i = 0; i < tile->oid_da.len; i++)
 		{
-			g_law_da[i].function(oid);
+			law_lod_oid_da_add_rec(tile->oid_da.arr[i]);
+		}
+	}
+}
 
-			/* The object might have been destroyed. */
-			obj = get_obj(oid);
-			if (obj == NULL)
-			{
-				goto next_obj;
-			}
+static oid_t law_lod_clone_obj(oid_t oid, loc_t loc)
+{
+	oid_t clone_oid = obj_create(obj_type(oid), loc, obj_max_life(oid), obj_material_id(oid));
+	obj_t* obj = get_obj(oid);
+	for (int i = 0; i < obj->attached_da.len; i++)
+	{
+		oid_t const sub_oid = obj->attached_da.arr[i];
+		if (oid_eq(sub_oid, g_player_oid))
+		{
+			continue;
 		}
+		law_lod_clone_obj(sub_oid, (loc_t){.type = LOC_ATTACHED_TO_OBJ,
+			.attached_to_obj = {
+				.oid = clone_oid,
+				.attachment = get_obj(sub_oid)->loc.attached_to_obj.attachment}});
+	}
+	return clone_oid;
+}
+
+static void law_chunk_make_far(int chunk_index)
+{
+	law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+	chunk->is_far = true;
+	law_chunk_list_all_objs(chunk_index);
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		chunk->far_count_table[type] = 0;
+		chunk->far_log_growth_table[type] = g_law_lod_log_growth_table[type];
+	}
+	for (int i = 0; i < g_law_lod_oid_da_len; i++)
+	{
+		chunk->far_count_table[obj_type(g_law_lod_oid_da[i])]++;
+		obj_sleep(g_law_lod_oid_da[i]);
+	}
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		g_law_lod_far_count_table[type] += chunk->far_count_table[type];
+	}
+}
 
-		/* The object might have been destroyed. */
-		obj = get_obj(oid);
-		if (obj == NULL)
+static void law_chunk_make_near(int chunk_index)
+{
+	law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+	chunk->is_far = false;
+	tc_rect_t const rect = law_chunk_rect(chunk_index);
+	rng_begin_stream(rng_key(rng_key(rng_domain_key(RNG_DOMAIN_LAW_LOD), g_law_turn_number),
+		chunk_index));
+
+	/* Containers are done before what they contain (eggs before slimes), as cloning
+	 * a container also clones what is inside. */
+	for (int type = OBJ_TYPE_NUMBER-1; type >= 0; type--)
+	{
+		g_law_lod_far_count_table[type] -= chunk->far_count_table[type];
+		if ((g_law_obj_type_set & OBJ_TYPE_SET(type)) == 0)
 		{
 			continue;
 		}
+		double const growth =
+			exp(g_law_lod_log_growth_table[type] - chunk->far_log_growth_table[type]);
+		/* Not more than a tile worth of new objects. */
+		int const target_count = (int)fmin(chunk->far_count_table[type] * growth + 0.5,
+			chunk->far_count_table[type] + rect.w * rect.h);
 
-		if (obj->life <= 0)
+		/* The objects of the type that are on tiles (the others come with their containers). */
+		law_chunk_list_all_objs(chunk_index);
+		int count = 0, on_tile_count = 0;
+		for (int i = 0; i < g_law_lod_oid_da_len; i++)
+		{
+			oid_t const oid = g_law_lod_oid_da[i];
+			if ((int)obj_type(oid) == type)
+			{
+				count++;
+				if (get_obj(oid)->loc.type == LOC_TILE)
+				{
+					g_law_lod_oid_da[on_tile_count++] = oid;
+				}
+			}
+		}
+		if (on_tile_count == 0)
 		{
-			obj_destroy(oid);
 			continue;
 		}
 
-		next_obj:;
+		for (int i = count; i < target_count; i++)
+		{
+			/* A clone of one of them, on a tile that is not blocked if there is one. */
+			oid_t const model_oid = g_law_lod_oid_da[rng_rand() % on_tile_count];
+			for (int try = 0; try < 8; try++)
+			{
+				tc_t const tc = {
+					rect.x + rng_rand() % rect.w,
+					rect.y + rng_rand() % rect.h};
+				if (get_tile(tc)->blocking_obj_count == 0)
+				{
+					law_lod_clone_obj(model_oid, tc_to_loc(tc));
+					break;
+				}
+			}
+		}
+		for (int i = target_count; i < count && on_tile_count > 0; i++)
+		{
+			int const j = rng_rand() % on_tile_count;
+			if (!oid_eq(g_law_lod_oid_da[j], g_player_oid))
+			{
+				obj_destroy(g_law_lod_oid_da[j]);
+			}
+			g_law_lod_oid_da[j] = g_law_lod_oid_da[--on_tile_count];
+		}
+	}
+	rng_end_stream();
+
+	/* What was put on hold is done now. */
+	law_chunk_list_all_objs(chunk_index);
+	for (int i = 0; i < g_law_lod_oid_da_len; i++)
+	{
+		obj_wake(g_law_lod_oid_da[i]);
+	}
+	for (int i = 0; i < chunk->parked_event_da.len; i++)
+	{
+		law_event_t event = chunk->parked_event_da.arr[i];
+		if (get_obj(event.oid) != NULL)
+		{
+			event.turn = g_law_turn_number;
+			law_schedule(event);
+		}
+	}
+	chunk->parked_event_da.len = 0;
+}
+
+/* The laws applied to the objects of a near chunk may create, destroy or move objects
+ * on the tiles next to them, that may be in a far chunk next to it. The objects of such
+ * a far chunk are counted again, and what changed is counted as far, not as near growth. */
+static void law_chunk_recount_far(int chunk_index)
+{
+	law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+	int count_table[OBJ_TYPE_NUMBER] = {0};
+	law_chunk_list_all_objs(chunk_index);
+	for (int i = 0; i < g_law_lod_oid_da_len; i++)
+	{
+		count_table[obj_type(g_law_lod_oid_da[i])]++;
+	}
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		g_law_lod_far_count_table[type] += count_table[type] - chunk->far_count_table[type];
+		chunk->far_count_table[type] = count_table[type];
+	}
+}
+
+/* Is the chunk far with a near chunk next to it. */
+static bool law_chunk_is_far_border(int chunk_index)
+{
+	if (!g_law_chunk_arr[chunk_index].is_far)
+	{
+		return false;
+	}
+	int const chunk_x = chunk_index % g_law_chunk_w, chunk_y = chunk_index / g_law_chunk_w;
+	for (int y = max(chunk_y - 1, 0); y <= min(chunk_y + 1, g_law_chunk_h - 1); y++)
+	for (int x = max(chunk_x - 1, 0); x <= min(chunk_x + 1, g_law_chunk_w - 1); x++)
+	{
+		if (!g_law_chunk_arr[y * g_law_chunk_w + x].is_far)
+		{
+			return true;
+		}
 	}
+	return false;
 }
 
+/* Measures how the populations near the player grew since the previous update,
+ * and makes the chunks that got far or near so. */
+static void law_lod_update(void)
+{
+	for (int i = 0; i < g_law_chunk_w * g_law_chunk_h; i++)
+	{
+		if (law_chunk_is_far_border(i))
+		{
+			law_chunk_recount_far(i);
+		}
+	}
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		int const near_prev_count = g_law_lod_prev_near_count_table[type];
+		int const near_count = obj_type_count(type) - g_law_lod_far_count_table[type];
+		if (near_prev_count > 0 && near_count > 0)
+		{
+			g_law_lod_log_growth_table[type] += log((double)near_count / near_prev_count);
+		}
+	}
+
+	obj_t* player_obj = get_obj(g_player_oid);
+	bool const lod_is_enabled =
+		g_law_lod_radius > 0 && (g_law_lod_center_is_fixed || player_obj != NULL);
+	tc_t const center_tc =
+		!lod_is_enabled ? (tc_t){0, 0} :
+		g_law_lod_center_is_fixed ? g_law_lod_center_tc :
+		loc_to_tc(player_obj->loc);
+	for (int i = 0; i < g_law_chunk_w * g_law_chunk_h; i++)
+	{
+		bool const is_far = lod_is_enabled && law_chunk_is_far(i, center_tc);
+		if (is_far && !g_law_chunk_arr[i].is_far)
+		{
+			law_chunk_make_far(i);
+		}
+		else if (!is_far && g_law_chunk_arr[i].is_far)
+		{
+			law_chunk_make_near(i);
+		}
+	}
+
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		g_law_lod_prev_near_count_table[type] =
+			obj_type_count(type) - g_law_lod_far_count_table[type];
+	}
+}
+
+static void law_chunks_list_objs(void)
+{
+	int const chunk_w = (g_mg_rect.w + LAW_CHUNK_SIDE - 1) / LAW_CHUNK_SIDE;
+	int const chunk_h = (g_mg_rect.h + LAW_CHUNK_SIDE - 1) / LAW_CHUNK_SIDE;
+	if (chunk_w != g_law_chunk_w || chunk_h != g_law_chunk_h)
+	{
+		for (int i = 0; i < g_law_chunk_w * g_law_chunk_h; i++)
+		{
+			free(g_law_chunk_arr[i].oid_arr);
+			free(g_law_chunk_arr[i].due_event_da.arr);
+			free(g_law_chunk_arr[i].scheduled_event_da.arr);
+			free(g_law_chunk_arr[i].reservation.index_arr);
+			free(g_law_chunk_arr[i].law_stats_arr);
+			free(g_law_chunk_arr[i].intent_da.arr);
+			free(g_law_chunk_arr[i].call_da.arr);
+			free(g_law_chunk_arr[i].move_da.arr);
+			free(g_law_chunk_arr[i].dst_move_da.arr);
+			free(g_law_chunk_arr[i].parked_event_da.arr);
+		}
+		free(g_law_chunk_arr);
+		g_law_chunk_arr = calloc(chunk_w * chunk_h, sizeof(law_chunk_t));
+		assert(g_law_chunk_arr != NULL);
+		g_law_chunk_w = chunk_w;
+		g_law_chunk_h = chunk_h;
+		g_law_chunk_law_number = 0;
+		for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+		{
+			g_law_lod_far_count_table[type] = 0;
+		}
+	}
+	if (g_law_chunk_law_number != g_law_da_len)
+	{
+		for (int i = 0; i < chunk_w * chunk_h; i++)
+		{
+			free(g_law_chunk_arr[i].law_stats_arr);
+			g_law_chunk_arr[i].law_stats_arr = calloc(g_law_da_len, sizeof(law_stats_t));
+			assert(g_law_chunk_arr[i].law_stats_arr != NULL);
+		}
+		g_law_chunk_law_number = g_law_da_len;
+	}
+	for (int i = 0; i < chunk_w * chunk_h; i++)
+	{
+		g_law_chunk_arr[i].oid_len = 0;
+		g_law_chunk_arr[i].due_event_da.len = 0;
+		g_law_chunk_arr[i].creation_bound = 0;
+	}
+
+	law_lod_update();
+
+	/* Only the awake objects are given to the laws applied every turn
+	 * (the others have nothing to do). */
+	oid_t oid = OID_NULL;
+	while (oid_iter_awake(&oid))
+	{
+		law_chunk_t* chunk = law_chunk_of_obj(oid);
+		if (chunk->is_far)
+		{
+			/* Woken by something happening next to its chunk. */
+			obj_sleep(oid);
+			continue;
+		}
+		DA_LENGTHEN(chunk->oid_len += 1, chunk->oid_cap, chunk->oid_arr, oid_t);
+		chunk->oid_arr[chunk->oid_len-1] = oid;
+		chunk->creation_bound += g_law_max_created_obj_number_table[obj_type(oid)];
+	}
+	/* The awake objects are listed in an order that depends on how the threads
+	 * interleaved in the previous turns. */
+	for (int i = 0; i < chunk_w * chunk_h; i++)
+	{
+		if (g_law_chunk_arr[i].oid_len > 1)
+		{
+			qsort(g_law_chunk_arr[i].oid_arr, g_law_chunk_arr[i].oid_len, sizeof(oid_t),
+				compare_oid_indices);
+		}
+	}
+
+	/* The events due this turn go to the chunks where their objects are. */
+	law_event_da_t* slot = &g_law_wheel[g_law_turn_number % LAW_WHEEL_SIZE];
+	int kept_len = 0;
+	for (int i = 0; i < slot->len; i++)
+	{
+		law_event_t const event = slot->arr[i];
+		if (event.turn != g_law_turn_number)
+		{
+			assert(event.turn > g_law_turn_number);
+			slot->arr[kept_len++] = event;
+			continue;
+		}
+		if (get_obj(event.oid) == NULL)
+		{
+			/* Destroyed in the meantime. */
+			continue;
+		}
+		law_chunk_t* chunk = law_chunk_of_obj(event.oid);
+		if (chunk->is_far)
+		{
+			law_event_da_add(&chunk->parked_event_da, event);
+			continue;
+		}
+		law_event_da_add(&chunk->due_event_da, event);
+		chunk->creation_bound += g_law_da[event.law_index].max_created_obj_number;
+	}
+	slot->len = kept_len;
+}
+
+static uint64_t law_obj_rng_key(oid_t oid)
+{
+	return rng_key(g_law_turn_rng_key,
+		((uint64_t)(uint32_t)oid.generation << 32) | (uint32_t)oid.index);
+}
+
+/* Applies a law to an object, counting the call in the profiling counters of the chunk. */
+static int law_chunk_call_law(law_chunk_t* chunk, int law_index, oid_t oid,
+	uint64_t obj_rng_key)
+{
+	unsigned int const change_count = obj_thread_change_count();
+	int const intent_begin = chunk->intent_da.len;
+	int const move_begin = chunk->move_da.len;
+	uint64_t const counter_begin = SDL_GetPerformanceCounter();
+	uint64_t const stream_key = rng_key(obj_rng_key, law_index);
+	t_law_call_priority = stream_key;
+	rng_begin_stream(stream_key);
+	int const turns = g_law_da[law_index].function(oid);
+	rng_end_stream();
+	law_stats_t* stats = &chunk->law_stats_arr[law_index];
+	stats->seconds += seconds_since(counter_begin);
+	stats->call_count++;
+	if (chunk->intent_da.len != intent_begin)
+	{
+		law_call_da_t* da = &chunk->call_da;
+		DA_LENGTHEN(da->len += 1, da->cap, da->arr, law_call_t);
+		da->arr[da->len-1] = (law_call_t){
+			.priority = stream_key,
+			.oid = oid,
+			.law_index = law_index,
+			.turns = turns,
+			.intent_begin = intent_begin,
+			.intent_len = chunk->intent_da.len - intent_begin};
+	}
+	bool const has_acted =
+		obj_thread_change_count() != change_count || chunk->intent_da.len != intent_begin;
+	if (has_acted)
+	{
+		stats->acting_call_count++;
+	}
+	for (int i = move_begin; i < chunk->move_da.len; i++)
+	{
+		chunk->move_da.arr[i].law_index = law_index;
+		chunk->move_da.arr[i].counts_as_acting = !has_acted && i == move_begin;
+	}
+	return turns;
+}
+
+static void law_chunk_apply(int chunk_index)
+{
+	law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+	obj_set_thread_reservation(&chunk->reservation);
+	t_law_intent_da = &chunk->intent_da;
+	t_law_move_da = &chunk->move_da;
+
+	for (int i = 0; i < chunk->oid_len; i++)
+	{
+		oid_t const oid = chunk->oid_arr[i];
+		if (get_obj(oid) == NULL)
+		{
+			/* Destroyed earlier in the turn. */
+			continue;
+		}
+		/* Each object is given to the laws that apply to its type, one after the other,
+		 * each law drawing from a stream of its own for this object in this turn. */
+		uint64_t const obj_rng_key = law_obj_rng_key(oid);
+		law_index_da_t const* da = &g_law_dispatch_table[obj_type(oid)];
+		bool has_something_to_do = false;
+		for (int j = 0; j < da->len; j++)
+		{
+			if (law_chunk_call_law(chunk, da->arr[j], oid, obj_rng_key) != LAW_NEVER_AGAIN)
+			{
+				has_something_to_do = true;
+			}
+			if (get_obj(oid) == NULL)
+			{
+				/* The object was destroyed by the law, no more laws for it. */
+				break;
+			}
+		}
+		if (!has_something_to_do && get_obj(oid) != NULL)
+		{
+			obj_sleep(oid);
+		}
+	}
+
+	for (int i = 0; i < chunk->due_event_da.len; i++)
+	{
+		law_event_t event = chunk->due_event_da.arr[i];
+		if (get_obj(event.oid) == NULL)
+		{
+			continue;
+		}
+		int const call_len = chunk->call_da.len;
+		int const turns = law_chunk_call_law(chunk, event.law_index, event.oid,
+			law_obj_rng_key(event.oid));
+		if (chunk->call_da.len != call_len)
+		{
+			/* It recorded intents, the merge schedules the next call depending on whether
+			 * they can be applied (see `law_merge_intents`). */
+			continue;
+		}
+		if (turns != LAW_NEVER_AGAIN && get_obj(event.oid) != NULL)
+		{
+			assert(turns >= 1);
+			event.turn = g_law_turn_number + turns;
+			law_event_da_add(&chunk->scheduled_event_da, event);
+		}
+	}
+
+	t_law_intent_da = NULL;
+	t_law_move_da = NULL;
+	obj_set_thread_reservation(NULL);
+}
+
+/* The worker threads wait for the chunks of a color to be given out (by `law_pool_run`),
+ * and every thread (the main one included) takes chunks from the list until there is
+ * none left, doing the job given with the list on each of them. */
+static pthread_mutex_t g_law_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_law_pool_work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_law_pool_done_cond = PTHREAD_COND_INITIALIZER;
+static int g_law_pool_worker_number = 0;
+/* Incremented for every list of chunks given out, so that workers know there is work. */
+static int g_law_pool_generation = 0;
+/* The chunks given out (the list belongs to the caller of `law_pool_run`). */
+static int const* g_law_pool_chunk_index_arr = NULL;
+static int g_law_pool_chunk_number = 0;
+static void (*g_law_pool_job)(int chunk_index) = NULL;
+static int g_law_pool_next_chunk = 0, g_law_pool_done_chunk_count = 0;
+
+/* Must be called with `g_law_pool_mutex` locked. */
+static void law_pool_work(void)
+{
+	while (g_law_pool_next_chunk < g_law_pool_chunk_number)
+	{
+		int const chunk_index = g_law_pool_chunk_index_arr[g_law_pool_next_chunk++];
+		pthread_mutex_unlock(&g_law_pool_mutex);
+		g_law_pool_job(chunk_index);
+		pthread_mutex_lock(&g_law_pool_mutex);
+		g_law_pool_done_chunk_count++;
+		if (g_law_pool_done_chunk_count == g_law_pool_chunk_number)
+		{
+			pthread_cond_signal(&g_law_pool_done_cond);
+		}
+	}
+}
+
+/* Workers live as long as the program. */
+static void* law_pool_worker_main(void* arg)
+{
+	(void)arg;
+	int generation_seen = 0;
+	pthread_mutex_lock(&g_law_pool_mutex);
+	while (true)
+	{
+		while (g_law_pool_generation == generation_seen)
+		{
+			pthread_cond_wait(&g_law_pool_work_cond, &g_law_pool_mutex);
+		}
+		generation_seen = g_law_pool_generation;
+		law_pool_work();
+	}
+	return NULL;
+}
+
+/* Does the given job on each of the given chunks, with the help of the workers. */
+static void law_pool_run(void (*job)(int chunk_index),
+	int const* chunk_index_arr, int chunk_number)
+{
+	while (g_law_pool_worker_number < g_law_thread_number - 1)
+	{
+		pthread_t thread;
+		int error = pthread_create(&thread, NULL, law_pool_worker_main, NULL);
+		assert(error == 0);
+		#ifndef DEBUG
+			(void)error;
+		#endif
+		pthread_detach(thread);
+		g_law_pool_worker_number++;
+	}
+
+	pthread_mutex_lock(&g_law_pool_mutex);
+	g_law_pool_chunk_index_arr = chunk_index_arr;
+	g_law_pool_chunk_number = chunk_number;
+	g_law_pool_job = job;
+	g_law_pool_next_chunk = 0;
+	g_law_pool_done_chunk_count = 0;
+	g_law_pool_generation++;
+	pthread_cond_broadcast(&g_law_pool_work_cond);
+	law_pool_work();
+	while (g_law_pool_done_chunk_count < g_law_pool_chunk_number)
+	{
+		pthread_cond_wait(&g_law_pool_done_cond, &g_law_pool_mutex);
+	}
+	/* Workers that are late to the party must not find anything to do. */
+	g_law_pool_chunk_index_arr = NULL;
+	g_law_pool_chunk_number = 0;
+	pthread_mutex_unlock(&g_law_pool_mutex);
+}
+
+/* Section dedicated to the merge of the intents recorded by the laws in double-buffered
+ * mode, which is done by one thread once all the laws are applied. */
+
+/* All the calls that recorded intents in the turn. */
+static law_call_da_t g_law_merge_call_da;
+/* All the life changes of the turn. */
+static law_intent_da_t g_law_merge_life_da;
+/* For each tile, the number (plus one) of the last turn where a blocking object created
+ * by a law was placed on it. */
+static uint64_t* g_law_merge_tile_stamp_arr = NULL;
+static int g_law_merge_tile_number = 0;
+
+static int compare_law_call_priorities(void const* a, void const* b)
+{
+	law_call_t const* call_a = a;
+	law_call_t const* call_b = b;
+	if (call_a->priority != call_b->priority)
+	{
+		return (call_a->priority > call_b->priority) - (call_a->priority < call_b->priority);
+	}
+	/* Two calls with the same priority is very unlikely, but it must not be a problem. */
+	if (call_a->oid.index != call_b->oid.index)
+	{
+		return compare_oid_indices(&call_a->oid, &call_b->oid);
+	}
+	return (call_a->law_index > call_b->law_index) - (call_a->law_index < call_b->law_index);
+}
+
+static int compare_law_intent_oid_indices(void const* a, void const* b)
+{
+	return compare_oid_indices(&((law_intent_t const*)a)->oid, &((law_intent_t const*)b)->oid);
+}
+
+/* Is the given intent the placement of a blocking object on a tile. */
+static bool law_intent_places_blocking_obj(law_intent_t const* intent)
+{
+	return intent->type == LAW_INTENT_PLACE && intent->loc.type == LOC_TILE &&
+		obj_type_is_blocking(obj_type(intent->oid));
+}
+
+/* Applies the intents of all the chunks to the world, in phases:
+ * - Placements, call by call. Two blocking objects created by laws cannot end up on
+ *   the same tile in the same turn (like two trees grown from two seeds of a tile),
+ *   so the call that comes second does not happen at all (the objects it created are
+ *   destroyed and its other intents are ignored) and is tried again in the next turn,
+ *   whatever it returned. The next call of a scheduled law that recorded intents is
+ *   scheduled here for that reason, instead of when the law was applied.
+ * - Life changes, which are added up (so that two crystals healing the same object
+ *   heal it twice), without healing an object beyond its max life.
+ * - Destructions, destroying an object several times being the same as doing it once.
+ * The moves are then resolved like in the other mode (see `law_resolve_moves`). */
+static void law_merge_intents(void)
+{
+	int const tile_number = g_mg_rect.w * g_mg_rect.h;
+	if (tile_number != g_law_merge_tile_number)
+	{
+		free(g_law_merge_tile_stamp_arr);
+		g_law_merge_tile_stamp_arr = calloc(tile_number, sizeof(uint64_t));
+		assert(g_law_merge_tile_stamp_arr != NULL);
+		g_law_merge_tile_number = tile_number;
+	}
+	uint64_t const stamp = g_law_turn_number + 1;
+
+	g_law_merge_call_da.len = 0;
+	for (int i = 0; i < g_law_chunk_w * g_law_chunk_h; i++)
+	{
+		law_chunk_t* chunk = &g_law_chunk_arr[i];
+		for (int j = 0; j < chunk->call_da.len; j++)
+		{
+			law_call_t call = chunk->call_da.arr[j];
+			call.intent_arr = &chunk->intent_da.arr[call.intent_begin];
+			law_call_da_t* da = &g_law_merge_call_da;
+			DA_LENGTHEN(da->len += 1, da->cap, da->arr, law_call_t);
+			da->arr[da->len-1] = call;
+		}
+	}
+	law_call_t* call_arr = g_law_merge_call_da.arr;
+	int const call_number = g_law_merge_call_da.len;
+	if (call_number > 1)
+	{
+		qsort(call_arr, call_number, sizeof(law_call_t), compare_law_call_priorities);
+	}
+
+	/* Placements. */
+	for (int i = 0; i < call_number; i++)
+	{
+		law_call_t* call = &call_arr[i];
+		for (int j = 0; j < call->intent_len; j++)
+		{
+			law_intent_t const* intent = &call->intent_arr[j];
+			if (law_intent_places_blocking_obj(intent))
+			{
+				tc_t const tc = intent->loc.tile.tc;
+				if (g_law_merge_tile_stamp_arr[tile_index(tc)] == stamp)
+				{
+					call->failed = true;
+					break;
+				}
+			}
+		}
+		if (call->failed)
+		{
+			for (int j = 0; j < call->intent_len; j++)
+			{
+				if (call->intent_arr[j].type == LAW_INTENT_PLACE)
+				{
+					obj_destroy(call->intent_arr[j].oid);
+				}
+			}
+			if (g_law_da[call->law_index].is_scheduled)
+			{
+				law_schedule((law_event_t){
+					.turn = g_law_turn_number + 1,
+					.oid = call->oid,
+					.law_index = call->law_index});
+			}
+			else
+			{
+				obj_wake(call->oid);
+			}
+			continue;
+		}
+		if (g_law_da[call->law_index].is_scheduled && call->turns != LAW_NEVER_AGAIN)
+		{
+			assert(call->turns >= 1);
+			law_schedule((law_event_t){
+				.turn = g_law_turn_number + call->turns,
+				.oid = call->oid,
+				.law_index = call->law_index});
+		}
+		for (int j = 0; j < call->intent_len; j++)
+		{
+			law_intent_t const* intent = &call->intent_arr[j];
+			if (intent->type != LAW_INTENT_PLACE)
+			{
+				continue;
+			}
+			obj_change_loc(intent->oid, intent->loc);
+			if (law_intent_places_blocking_obj(intent))
+			{
+				tc_t const tc = intent->loc.tile.tc;
+				g_law_merge_tile_stamp_arr[tile_index(tc)] = stamp;
+			}
+		}
+	}
+
+	/* Life changes, added up per object. */
+	g_law_merge_life_da.len = 0;
+	for (int i = 0; i < call_number; i++)
+	{
+		for (int j = 0; !call_arr[i].failed && j < call_arr[i].intent_len; j++)
+		{
+			if (call_arr[i].intent_arr[j].type == LAW_INTENT_LIFE)
+			{
+				law_intent_da_t* da = &g_law_merge_life_da;
+				DA_LENGTHEN(da->len += 1, da->cap, da->arr, law_intent_t);
+				da->arr[da->len-1] = call_arr[i].intent_arr[j];
+			}
+		}
+	}
+	if (g_law_merge_life_da.len > 1)
+	{
+		qsort(g_law_merge_life_da.arr, g_law_merge_life_da.len, sizeof(law_intent_t),
+			compare_law_intent_oid_indices);
+	}
+	for (int i = 0; i < g_law_merge_life_da.len;)
+	{
+		oid_t const oid = g_law_merge_life_da.arr[i].oid;
+		int life_delta = 0;
+		for (; i < g_law_merge_life_da.len && oid_eq(g_law_merge_life_da.arr[i].oid, oid); i++)
+		{
+			life_delta += g_law_merge_life_da.arr[i].life_delta;
+		}
+		int life = obj_life(oid) + life_delta;
+		if (life_delta > 0)
+		{
+			life = min(life, max(obj_life(oid), obj_max_life(oid)));
+		}
+		obj_set_life(oid, life);
+	}
+
+	/* Destructions. */
+	for (int i = 0; i < call_number; i++)
+	{
+		for (int j = 0; !call_arr[i].failed && j < call_arr[i].intent_len; j++)
+		{
+			law_intent_t const* intent = &call_arr[i].intent_arr[j];
+			if (intent->type == LAW_INTENT_DESTROY && get_obj(intent->oid) != NULL)
+			{
+				obj_destroy(intent->oid);
+			}
+		}
+	}
+
+	for (int i = 0; i < g_law_chunk_w * g_law_chunk_h; i++)
+	{
+		g_law_chunk_arr[i].intent_da.len = 0;
+		g_law_chunk_arr[i].call_da.len = 0;
+	}
+}
+
+/* The chunks being processed (of some color, or all of them). */
+static int* g_law_pass_chunk_index_da = NULL;
+static int g_law_pass_chunk_index_da_len = 0, g_law_pass_chunk_index_da_cap = 0;
+
+static void law_pass_chunk_index_da_add(int chunk_index)
+{
+	DA_LENGTHEN(g_law_pass_chunk_index_da_len += 1, g_law_pass_chunk_index_da_cap,
+		g_law_pass_chunk_index_da, int);
+	g_law_pass_chunk_index_da[g_law_pass_chunk_index_da_len-1] = chunk_index;
+}
+
+/* Adds the profiling counters of the chunk to the counters of the laws. */
+static void law_chunk_flush_stats(law_chunk_t* chunk)
+{
+	for (int i = 0; i < g_law_da_len; i++)
+	{
+		law_stats_t* stats = &g_law_da[i].stats;
+		law_stats_t* chunk_stats = &chunk->law_stats_arr[i];
+		stats->call_count += chunk_stats->call_count;
+		stats->acting_call_count += chunk_stats->acting_call_count;
+		stats->seconds += chunk_stats->seconds;
+		*chunk_stats = (law_stats_t){0};
+	}
+}
+
+/* Index of the given tile (given by its index in the map grid, see `tile_index`) in
+ * its chunk, or -1 if it is not in the given chunk. */
+static int law_chunk_local_tile_index(int chunk_index, int mg_index)
+{
+	tc_t const tc = tile_index_to_tc(mg_index);
+	tc_rect_t const rect = law_chunk_rect(chunk_index);
+	int const x = tc.x - rect.x, y = tc.y - rect.y;
+	if (x < 0 || LAW_CHUNK_SIDE <= x || y < 0 || LAW_CHUNK_SIDE <= y)
+	{
+		return -1;
+	}
+	return y * LAW_CHUNK_SIDE + x;
+}
+
+/* Gathers the moves to the tiles of the chunk (from the chunk and the chunks around it,
+ * as a move only goes to a tile next to the object) sorted by destination tile and then
+ * by priority, and settles them against the tiles as they are once all the laws are applied
+ * (which no thread changes while this is done). */
+static void law_chunk_settle_moves(int chunk_index)
+{
+	law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+	int const chunk_x = chunk_index % g_law_chunk_w, chunk_y = chunk_index / g_law_chunk_w;
+
+	/* Counting sort by destination tile, done in two passes over the chunks around. */
+	int tile_count_arr[LAW_CHUNK_SIDE * LAW_CHUNK_SIDE + 1] = {0};
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int y = max(chunk_y - 1, 0); y <= min(chunk_y + 1, g_law_chunk_h - 1); y++)
+		for (int x = max(chunk_x - 1, 0); x <= min(chunk_x + 1, g_law_chunk_w - 1); x++)
+		{
+			law_move_da_t const* src_da = &g_law_chunk_arr[y * g_law_chunk_w + x].move_da;
+			for (int i = 0; i < src_da->len; i++)
+			{
+				int const local_index =
+					law_chunk_local_tile_index(chunk_index, src_da->arr[i].dst_tile_index);
+				if (local_index < 0)
+				{
+					continue;
+				}
+				if (pass == 0)
+				{
+					tile_count_arr[local_index + 1]++;
+				}
+				else
+				{
+					chunk->dst_move_da.arr[tile_count_arr[local_index]++] = src_da->arr[i];
+				}
+			}
+		}
+		if (pass == 0)
+		{
+			for (int i = 0; i < LAW_CHUNK_SIDE * LAW_CHUNK_SIDE; i++)
+			{
+				tile_count_arr[i + 1] += tile_count_arr[i];
+			}
+			law_move_da_t* da = &chunk->dst_move_da;
+			DA_LENGTHEN(da->len = tile_count_arr[LAW_CHUNK_SIDE * LAW_CHUNK_SIDE], da->cap,
+				da->arr, law_move_t);
+		}
+	}
+
+	law_move_da_t* da = &chunk->dst_move_da;
+	int group_begin = 0;
+	while (group_begin < da->len)
+	{
+		int group_end = group_begin + 1;
+		while (group_end < da->len &&
+			da->arr[group_end].dst_tile_index == da->arr[group_begin].dst_tile_index)
+		{
+			group_end++;
+		}
+
+		/* The moves to the same tile are few, sorted by priority (and then by object
+		 * for the calls that asked for several moves). */
+		for (int i = group_begin + 1; i < group_end; i++)
+		{
+			law_move_t const move = da->arr[i];
+			int j = i;
+			while (j > group_begin &&
+				(da->arr[j-1].priority > move.priority ||
+					(da->arr[j-1].priority == move.priority &&
+						compare_oid_indices(&da->arr[j-1].oid, &move.oid) > 0)))
+			{
+				da->arr[j] = da->arr[j-1];
+				j--;
+			}
+			da->arr[j] = move;
+		}
+
+		/* Something blocking on the tile blocks it even if it is leaving, and else the
+		 * first blocking object to move there gets it. */
+		tile_t const* tile = get_tile(tile_index_to_tc(da->arr[group_begin].dst_tile_index));
+		bool is_taken = tile->blocking_obj_count > 0;
+		for (int i = group_begin; i < group_end; i++)
+		{
+			law_move_t* move = &da->arr[i];
+			move->outcome = LAW_MOVE_BLOCKED;
+			obj_t const* obj = get_obj(move->oid);
+			if (obj == NULL || obj->loc.type != LOC_TILE)
+			{
+				/* Destroyed (or put somewhere else) in the meantime. */
+				continue;
+			}
+			if (tile->hittable_obj_count > 0)
+			{
+				for (int j = 0; j < tile->oid_da.len; j++)
+				{
+					if (obj_can_get_hit_for_now(tile->oid_da.arr[j]))
+					{
+						move->outcome = LAW_MOVE_HIT;
+						move->hit_oid = tile->oid_da.arr[j];
+						break;
+					}
+				}
+				if (move->outcome == LAW_MOVE_HIT)
+				{
+					continue;
+				}
+			}
+			if (obj_is_blocking(move->oid))
+			{
+				if (is_taken)
+				{
+					continue;
+				}
+				is_taken = true;
+			}
+			move->outcome = LAW_MOVE_DONE;
+		}
+		group_begin = group_end;
+	}
+}
+
+/* Does the moves to the tiles of the chunk, as they were settled. */
+static void law_chunk_apply_moves(int chunk_index)
+{
+	law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+	law_move_da_t* da = &chunk->dst_move_da;
+	for (int i = 0; i < da->len; i++)
+	{
+		law_move_t const* move = &da->arr[i];
+		obj_t* obj = get_obj(move->oid);
+		if (move->outcome == LAW_MOVE_BLOCKED || obj == NULL || obj->loc.type != LOC_TILE)
+		{
+			continue;
+		}
+		tc_t const dst_tc = tc_add_tm(loc_to_tc(obj->loc), move->move);
+		if (!tc_in_rect(dst_tc, g_mg_rect) || tile_index(dst_tc) != move->dst_tile_index)
+		{
+			/* It moved since it asked for this move (by an other move of the same object,
+			 * only the first one is done). */
+			continue;
+		}
+		if (move->outcome == LAW_MOVE_HIT)
+		{
+			obj_t const* hit_obj = get_obj(move->hit_oid);
+			if (hit_obj == NULL || hit_obj->loc.type != LOC_TILE ||
+				!tc_eq(loc_to_tc(hit_obj->loc), dst_tc))
+			{
+				/* What it was to hit moved away (by a move done in an earlier pass),
+				 * it is blocked like it would have been by anything else on the tile. */
+				continue;
+			}
+			obj_hits_obj(move->oid, move->hit_oid);
+		}
+		else
+		{
+			obj_move(move->oid, move->move);
+		}
+		if (move->counts_as_acting)
+		{
+			chunk->law_stats_arr[move->law_index].acting_call_count++;
+		}
+	}
+	da->len = 0;
+}
+
+/* The laws do not move objects while they are applied, they ask for moves instead (so that
+ * they can do it from several threads, and so that what they see does not depend on which
+ * object moved first). Each move is then settled against the tiles as they are once all the
+ * laws are applied, so that it does not depend on which other moves were done before it:
+ * the object hits what can be hit on the tile it tries to move to, or is blocked if something
+ * blocking is there (even if that is leaving) or if a blocking object whose move has a better
+ * priority gets the tile, or else moves there (see `law_chunk_settle_moves`).
+ * Both the settling and the moves are done by the chunks of the destination tiles on several
+ * threads, the moves being done in the same four passes as the laws (as a move only touches
+ * the tiles around its destination tile, see `obj_change_loc`). */
+static void law_resolve_moves(void)
+{
+	g_law_pass_chunk_index_da_len = 0;
+	for (int chunk_y = 0; chunk_y < g_law_chunk_h; chunk_y++)
+	for (int chunk_x = 0; chunk_x < g_law_chunk_w; chunk_x++)
+	{
+		bool has_moves_around = false;
+		for (int y = max(chunk_y - 1, 0); y <= min(chunk_y + 1, g_law_chunk_h - 1); y++)
+		for (int x = max(chunk_x - 1, 0); x <= min(chunk_x + 1, g_law_chunk_w - 1); x++)
+		{
+			has_moves_around |= g_law_chunk_arr[y * g_law_chunk_w + x].move_da.len > 0;
+		}
+		if (has_moves_around)
+		{
+			law_pass_chunk_index_da_add(chunk_y * g_law_chunk_w + chunk_x);
+		}
+	}
+	law_pool_run(law_chunk_settle_moves,
+		g_law_pass_chunk_index_da, g_law_pass_chunk_index_da_len);
+	for (int i = 0; i < g_law_chunk_w * g_law_chunk_h; i++)
+	{
+		g_law_chunk_arr[i].move_da.len = 0;
+	}
+
+	for (int color = 0; color < 4; color++)
+	{
+		g_law_pass_chunk_index_da_len = 0;
+		for (int chunk_y = color / 2; chunk_y < g_law_chunk_h; chunk_y += 2)
+		for (int chunk_x = color % 2; chunk_x < g_law_chunk_w; chunk_x += 2)
+		{
+			int const chunk_index = chunk_y * g_law_chunk_w + chunk_x;
+			if (g_law_chunk_arr[chunk_index].dst_move_da.len > 0)
+			{
+				law_pass_chunk_index_da_add(chunk_index);
+			}
+		}
+		law_pool_run(law_chunk_apply_moves,
+			g_law_pass_chunk_index_da, g_law_pass_chunk_index_da_len);
+		for (int i = 0; i < g_law_pass_chunk_index_da_len; i++)
+		{
+			law_chunk_flush_stats(&g_law_chunk_arr[g_law_pass_chunk_index_da[i]]);
+		}
+	}
+}
+
+void apply_laws(void)
+{
+	uint64_t counter_begin = SDL_GetPerformanceCounter();
+	age_all_objs();
+	g_turn_phase_seconds_table[TURN_PHASE_AGING] += seconds_since(counter_begin);
+
+	counter_begin = SDL_GetPerformanceCounter();
+	obj_flush_created(law_schedule_new_obj);
+	law_chunks_list_objs();
+	law_perceive();
+	g_law_turn_rng_key = rng_key(rng_domain_key(RNG_DOMAIN_LAW), g_law_turn_number);
+	/* In double-buffered mode, the world does not change while the laws are applied,
+	 * so all the chunks can be processed at once instead of color by color. */
+	int const color_number = g_law_double_buffered ? 1 : 4;
+	int const color_stride = g_law_double_buffered ? 1 : 2;
+	for (int color = 0; color < color_number; color++)
+	{
+		/* The chunks of this color, reserving entries for them in a fixed order. */
+		g_law_pass_chunk_index_da_len = 0;
+		for (int chunk_y = color / 2; chunk_y < g_law_chunk_h; chunk_y += color_stride)
+		for (int chunk_x = color % 2; chunk_x < g_law_chunk_w; chunk_x += color_stride)
+		{
+			int const chunk_index = chunk_y * g_law_chunk_w + chunk_x;
+			law_chunk_t* chunk = &g_law_chunk_arr[chunk_index];
+			if (chunk->oid_len == 0 && chunk->due_event_da.len == 0)
+			{
+				continue;
+			}
+			obj_reserve(&chunk->reservation, chunk->creation_bound);
+			law_pass_chunk_index_da_add(chunk_index);
+		}
+
+		law_pool_run(law_chunk_apply, g_law_pass_chunk_index_da, g_law_pass_chunk_index_da_len);
+
+		for (int i = 0; i < g_law_pass_chunk_index_da_len; i++)
+		{
+			law_chunk_t* chunk = &g_law_chunk_arr[g_law_pass_chunk_index_da[i]];
+			obj_unreserve(&chunk->reservation);
+			for (int j = 0; j < chunk->scheduled_event_da.len; j++)
+			{
+				law_schedule(chunk->scheduled_event_da.arr[j]);
+			}
+			chunk->scheduled_event_da.len = 0;
+			law_chunk_flush_stats(chunk);
+		}
+	}
+	if (g_law_double_buffered)
+	{
+		law_merge_intents();
+	}
+	g_turn_phase_seconds_table[TURN_PHASE_LAWS] += seconds_since(counter_begin);
+
+	counter_begin = SDL_GetPerformanceCounter();
+	law_resolve_moves();
+	g_law_turn_number++;
+	g_turn_phase_seconds_table[TURN_PHASE_MOVES] += seconds_since(counter_begin);
+
+	counter_begin = SDL_GetPerformanceCounter();
+	destroy_dead_objs();
+	g_turn_phase_seconds_table[TURN_PHASE_DEATHS] += seconds_since(counter_begin);
+}
@@ -4,16 +4,74 @@
 
 #include "objects.h"
 
+/* Profiling counters of a law, accumulated over all the turns. */
+struct law_stats_t
+{
+	long long call_count;
+	/* How many of the calls changed something (see `obj_thread_change_count`),
+	 * or recorded intents to do so in double-buffered mode, or asked for a move that was
+	 * then done or hit something (a blocked move does not count, see `law_resolve_moves`). */
+	long long acting_call_count;
+	double seconds;
+};
+typedef struct law_stats_t law_stats_t;
+
+/* Laws are applied to several parts of the map at once (see `apply_laws`), so a law
+ * must only touch its object, its subobjects and the objects on its tile or on the tiles
+ * next to it, must not create more objects than it says, and must draw random numbers
+ * via `rng_rand`. It must also change the world only via `law_set_life`, `law_create`,
+ * `law_destroy` and `law_try_move` (see `g_law_double_buffered`), the moves being only
+ * done once all the laws are applied (in any mode). */
 struct law_t
 {
 	const char* name;
-	void (*function)(oid_t oid);
+	/* Returns in how many turns the law is to be applied to the object again (at least 1),
+	 * or `LAW_NEVER_AGAIN`. For a law that is not scheduled, `LAW_NEVER_AGAIN` means not
+	 * until something happens around the object, which is then put to sleep if all these
+	 * laws agree (see `obj_sleep`). */
+	int (*function)(oid_t oid);
+	/* The law is only applied to the objects of these types. */
+	obj_type_set_t obj_type_set;
+	/* How many objects a call to the law may create, at most. */
+	int max_created_obj_number;
+	/* A law that is not scheduled is applied to every object of its types every turn
+	 * (and what it returns is ignored). A scheduled law is applied to an object for the
+	 * first time in the turn it reaches `first_age`, and then only in the turns it asks for,
+	 * so that objects cost nothing in the turns where nothing is due for them. */
+	bool is_scheduled;
+	int first_age;
+	/* Updated by `apply_laws`. */
+	law_stats_t stats;
 };
 typedef struct law_t law_t;
 
+#define LAW_NEVER_AGAIN 0
+
 extern law_t* g_law_da;
 extern int g_law_da_len, g_law_da_cap;
 
+/* Number of threads that apply the laws (the main thread included). */
+extern int g_law_thread_number;
+
+/* In double-buffered mode, the world is not changed while the laws are applied, so every
+ * law sees the world as it was at the beginning of the turn whatever the order in which
+ * the objects are given to the laws. What the laws do is recorded instead (as intents),
+ * and applied in a merge step once all the laws are applied, which resolves the conflicts
+ * (see `law_merge_intents`). As nothing is changed, all the parts of the map are given
+ * to the laws at once instead of in four passes. */
+extern bool g_law_double_buffered;
+
+/* If not 0, the parts of the map that are farther than that from the player are not
+ * simulated exactly, the laws leave their objects alone. Their populations of each type are
+ * assumed to grow like the populations near the player do instead, and objects are cloned
+ * or destroyed to match when they get near the player again. The cost of a turn then
+ * depends on what is near the player rather than on the size of the map. */
+extern int g_law_lod_radius;
+/* If set, the level of detail is centered on `g_law_lod_center_tc` instead of on the player
+ * (so that it stays the same if the player dies, as in the headless runs). */
+extern bool g_law_lod_center_is_fixed;
+extern tc_t g_law_lod_center_tc;
+
 void register_laws(void);
 void apply_laws(void);
 
@@ -10,12 +10,17 @@
 #include "tc.h"
 #include "laws.h"
 #include "gameloop.h"
+#include "bench.h"
+#include "rng.h"
+#include "vision.h"
 #include <time.h>
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <limits.h>
 #include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
@@ -26,52 +31,7 @@ void recompute_vision(void)
 	{
 		return;
 	}
-
-	for (int y = 0; y < g_mg_rect.h; y++)
-	for (int x = 0; x < g_mg_rect.w; x++)
-	{
-		tc_t tc = {x, y};
-		tile_t* tile = get_tile(tc);
-		tile->vision = 0;
-	}
-
-	tc_t src_tc = loc_to_tc(player_obj->loc);
-
-	for (int y = 0; y < g_mg_rect.h; y++)
-	for (int x = 0; x < g_mg_rect.w; x++)
-	{
-		tc_t tc = {x, y};
-		tile_t* tile = get_tile(tc);
-		if (tile->vision != 0)
-		{
-			continue;
-		}
-		
-		int vision = 5;
-		bresenham_it_t it = line_bresenham_init(src_tc, tc);
-		while (line_bresenham_iter(&it))
-		{
-			tile_t* tile = get_tile(it.head);
-			tile->vision = max(tile->vision, vision);
-			if (tc_eq(it.head, src_tc))
-			{
-				continue;
-			}
-			for (int i = 0; i < tile->oid_da.len; i++)
-			{
-				oid_t oid = tile->oid_da.arr[i];
-				if (get_obj(oid) == NULL)
-				{
-					continue;
-				}
-				vision -= obj_vision_blocking(oid);
-			}
-			if (vision < 0)
-			{
-				vision = 0;
-			}
-		}
-	}
+	vision_compute(loc_to_tc(player_obj->loc));
 }
 
 struct text_particle_t
@@ -141,6 +101,15 @@ void draw_text_particles(camera_t camera)
 bool g_game_over = false;
 char* g_game_over_cause = NULL;
 
+/* Are turns being fast-forwarded (see `fast_forward`), in which case what is only there
+ * for the player to see (vision, visual effects, text particles and most of the log)
+ * is skipped. */
+bool g_fast_forwarding = false;
+
+/* Hits may happen in several threads at once (see `law_resolve_moves`), and they may log
+ * stuff, create text particles or end the game. */
+static pthread_mutex_t g_hit_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 void obj_hits_obj(oid_t oid_attacker, oid_t oid_target)
 {
 	obj_t* obj_attacker = get_obj(oid_attacker);
@@ -149,10 +118,13 @@ void obj_hits_obj(oid_t oid_attacker, oid_t oid_target)
 	{
 		return;
 	}
+	pthread_mutex_lock(&g_hit_mutex);
 	tc_t tc_attacker = loc_to_tc(obj_attacker->loc);
 	tc_t tc_target = loc_to_tc(obj_target->loc);
 	tm_t dir = tc_diff_as_tm(tc_attacker, tc_target);
-	bool event_visible = get_tile(tc_attacker)->vision > 0 || get_tile(tc_target)->vision > 0;
+	/* The vision is not up to date when fast-forwarding, and nobody is watching anyway. */
+	bool event_visible = !g_fast_forwarding &&
+		(get_tile_vision(tc_attacker) > 0 || get_tile_vision(tc_target) > 0);
 	
 	int damages = 1;
 	if (event_visible)
@@ -162,8 +134,8 @@ void obj_hits_obj(oid_t oid_attacker, oid_t oid_target)
 			(tcf_t){(float)tc_target.x, (float)tc_target.y},
 			400);
 	}
-	obj_target->life -= damages;
-	if (obj_target->life <= 0)
+	obj_set_life(oid_target, obj_life(oid_target) - damages);
+	if (obj_life(oid_target) <= 0)
 	{
 		if (event_visible)
 		{
@@ -178,7 +150,7 @@ void obj_hits_obj(oid_t oid_attacker, oid_t oid_target)
 		}
 		obj_destroy(oid_target);
 	}
-	else
+	else if (!g_fast_forwarding)
 	{
 		visual_effect_obj_da_add(&obj_target->visual_effect_da, (visual_effect_obj_t){
 			.type = VISUAL_EFFECT_OBJ_DAMAGED,
@@ -191,11 +163,31 @@ void obj_hits_obj(oid_t oid_attacker, oid_t oid_target)
 				obj_name(oid_attacker), obj_name(oid_target));
 		}
 	}
-	visual_effect_obj_da_add(&obj_attacker->visual_effect_da, (visual_effect_obj_t){
-		.type = VISUAL_EFFECT_OBJ_ATTACK,
-		.time_begin = g_game_time,
-		.time_end = g_game_time + 80,
-		.dir = dir});
+	if (!g_fast_forwarding)
+	{
+		visual_effect_obj_da_add(&obj_attacker->visual_effect_da, (visual_effect_obj_t){
+			.type = VISUAL_EFFECT_OBJ_ATTACK,
+			.time_begin = g_game_time,
+			.time_end = g_game_time + 80,
+			.dir = dir});
+	}
+	pthread_mutex_unlock(&g_hit_mutex);
+}
+
+/* Moves the object by `move` without checking whether it can (see `obj_try_move`). */
+void obj_move(oid_t oid, tm_t move)
+{
+	assert(get_obj(oid) != NULL);
+	obj_change_loc(oid, tc_to_loc(tc_add_tm(loc_to_tc(get_obj(oid)->loc), move)));
+
+	if (!g_fast_forwarding)
+	{
+		visual_effect_obj_da_add(&get_obj(oid)->visual_effect_da, (visual_effect_obj_t){
+			.type = VISUAL_EFFECT_OBJ_MOVE,
+			.time_begin = g_game_time,
+			.time_end = g_game_time + 60,
+			.dir = tm_reverse(move)});
+	}
 }
 
 void obj_try_move(oid_t oid, tm_t move)
@@ -208,39 +200,33 @@ void obj_try_move(oid_t oid, tm_t move)
 		return;
 	}
 
-	for (int i = 0; i < dst_tile->oid_da.len; i++)
+	if (dst_tile->hittable_obj_count > 0)
 	{
-		oid_t oid_on_dst = dst_tile->oid_da.arr[i];
-		obj_t* obj_on_dst = get_obj(oid_on_dst);
-		if (obj_on_dst == NULL)
-		{
-			continue;
-		}
-		else if (obj_can_get_hit_for_now(oid_on_dst))
-		{
-			obj_hits_obj(oid, oid_on_dst);
-			return;
-		}
-		else if (obj_is_blocking(oid) && obj_is_blocking(oid_on_dst))
+		for (int i = 0; i < dst_tile->oid_da.len; i++)
 		{
-			return;
+			oid_t oid_on_dst = dst_tile->oid_da.arr[i];
+			if (obj_can_get_hit_for_now(oid_on_dst))
+			{
+				obj_hits_obj(oid, oid_on_dst);
+				return;
+			}
 		}
 	}
+	if (dst_tile->blocking_obj_count > 0 && obj_is_blocking(oid))
+	{
+		return;
+	}
 
-	obj_change_loc(oid, tc_to_loc(dst_tc));
-
-	visual_effect_obj_da_add(&get_obj(oid)->visual_effect_da, (visual_effect_obj_t){
-		.type = VISUAL_EFFECT_OBJ_MOVE,
-		.time_begin = g_game_time,
-		.time_end = g_game_time + 60,
-		.dir = tm_reverse(move)});
+	obj_move(oid, move);
 }
 
 void generate_map_path(void)
 {
+	rng_begin_stream(rng_domain_key(RNG_DOMAIN_MAP_PATH));
+
 	tc_t crystal_tc = {
-		.x = g_mg_rect.x + g_mg_rect.w / 4 + rand() % (g_mg_rect.w / 9),
-		.y = g_mg_rect.y + g_mg_rect.h / 3 + rand() % (g_mg_rect.h / 3)};
+		.x = g_mg_rect.x + g_mg_rect.w / 4 + rng_rand() % (g_mg_rect.w / 9),
+		.y = g_mg_rect.y + g_mg_rect.h / 3 + rng_rand() % (g_mg_rect.h / 3)};
 	obj_create(OBJ_CRYSTAL, tc_to_loc(crystal_tc), 100, rand_material(MATERIAL_HARD));
 
 	/* Generate the path. */
@@ -272,7 +258,7 @@ void generate_map_path(void)
 				same_direction_steps == 1 ? 6 :
 				direction.x != 0 ? 4 :
 				2;
-			if (same_direction_steps >= 1 && rand() % keep_direction_force == 0)
+			if (same_direction_steps >= 1 && rng_rand() % keep_direction_force == 0)
 			{
 				/* Change the direction. */
 				tm_t new_direction = rand_tm_one();
@@ -327,6 +313,8 @@ void generate_map_path(void)
 		}
 	}
 	printf("Path generation try count: %d\n", path_try_count);
+
+	rng_end_stream();
 }
 
 void generate_map(void)
@@ -336,9 +324,13 @@ void generate_map(void)
 	biome_gen_t biome_gens[9];
 	for (int i = 0; i < (int)(sizeof biome_gens / sizeof biome_gens[0]); i++)
 	{
+		rng_begin_stream(rng_key(rng_domain_key(RNG_DOMAIN_BIOME), i));
 		biome_gens[i] = biome_gen_generate();
+		rng_end_stream();
 	}
 
+	/* Every tile is generated from a stream of its own. */
+	uint64_t const tile_rng_domain_key = rng_domain_key(RNG_DOMAIN_MAP_TILE);
 	for (int y = 0; y < g_mg_rect.h; y++)
 	for (int x = 0; x < g_mg_rect.w; x++)
 	{
@@ -349,6 +341,7 @@ void generate_map(void)
 		{
 			continue;
 		}
+		rng_begin_stream(rng_key(tile_rng_domain_key, (uint64_t)y * g_mg_rect.w + x));
 
 		#if 0
 		bool neighbor_to_path = false;
@@ -367,7 +360,7 @@ void generate_map(void)
 			((tc.y * 3) / g_mg_rect.h) * 3 + (tc.x * 3) / g_mg_rect.w];
 
 		obj_gen_t* gen = NULL;
-		int r = rand() % biome_gen->probability_sum;
+		int r = rng_rand() % biome_gen->probability_sum;
 		for (int i = 0; i < biome_gen->gen_number; i++)
 		{
 			r -= biome_gen->gen_probabilities[i].probability;
@@ -384,6 +377,8 @@ void generate_map(void)
 		{
 			obj_create(OBJ_MOSS, tc_to_loc(tc), 1, rand_material(MATERIAL_VEGETAL));
 		}
+
+		rng_end_stream();
 	}
 }
 
@@ -397,7 +392,8 @@ void draw_viewed_tiles(camera_t camera)
 	{
 		tc_t tc = {x, y};
 		tile_t const* tile = get_tile(tc);
-		if (tile->vision <= 0)
+		int const vision = get_tile_vision(tc);
+		if (vision <= 0)
 		{
 			continue;
 		}
@@ -423,13 +419,11 @@ void draw_viewed_tiles(camera_t camera)
 			OBJ_MOSS};
 		_Static_assert(sizeof type_priority / sizeof type_priority[0] == OBJ_TYPE_NUMBER,
 			"Some object types have not been added to the drawing priority list.");
+		obj_type_t type;
 		for (int i = 0; i < (int)(sizeof type_priority / sizeof type_priority[0]); i++)
 		{
-			oid = oid_da_find_type(&tile->oid_da, type_priority[i]);
-			if (get_obj(oid) == NULL)
-			{
-				oid = OID_NULL;
-			}
+			type = type_priority[i];
+			oid = oid_da_find_type(&tile->oid_da, type);
 			if (!oid_eq(oid, OID_NULL))
 			{
 				break;
@@ -444,8 +438,8 @@ void draw_viewed_tiles(camera_t camera)
 
 		if (!oid_eq(oid, OID_NULL))
 		{
-			text = obj_text_representation(oid);
-			text_stretch = obj_text_representation_stretch(oid);
+			text = obj_type_text_representation(type);
+			text_stretch = obj_type_text_representation_stretch(type);
 			text_color = obj_foreground_color(oid);
 			bg_color = obj_background_color(oid);
 		}
@@ -457,11 +451,11 @@ void draw_viewed_tiles(camera_t camera)
 
 		if (SDL_GetKeyboardState(NULL)[SDL_SCANCODE_LALT])
 		{
-			if (tile->vision > 0)
+			if (vision > 0)
 			{
 				bg_color = (rgb_t){
-					min(255, tile->vision * 30),
-					max(0, min(255, tile->vision * 30 - 255)),
+					min(255, vision * 30),
+					max(0, min(255, vision * 30 - 255)),
 					0};
 			}
 			else
@@ -527,12 +521,18 @@ void draw_viewed_tiles(camera_t camera)
 
 void perform_turn(void)
 {
+	/* Objects destroyed by the laws are released all together once all the laws
+	 * are applied. */
+	begin_deferred_obj_destruction();
 	apply_laws();
+	uint64_t counter_begin = SDL_GetPerformanceCounter();
+	end_deferred_obj_destruction();
+	g_turn_phase_seconds_table[TURN_PHASE_RELEASE] += seconds_since(counter_begin);
 
 	if (g_game_has_started)
 	{
 		obj_t* player_obj = get_obj(g_player_oid);
-		if (!g_game_over && (player_obj == NULL || player_obj->life <= 0))
+		if (!g_game_over && (player_obj == NULL || obj_life(g_player_oid) <= 0))
 		{
 			log_text("Game over.");
 			g_game_over = true;
@@ -540,9 +540,38 @@ void perform_turn(void)
 		}
 		else
 		{
-			recompute_vision();
+			if (!g_fast_forwarding)
+			{
+				counter_begin = SDL_GetPerformanceCounter();
+				recompute_vision();
+				g_turn_phase_seconds_table[TURN_PHASE_VISION] += seconds_since(counter_begin);
+			}
 			g_turn_number++;
 		}
+		if (!g_fast_forwarding)
+		{
+			log_turn_seperator();
+		}
+	}
+}
+
+/* Performs the given number of turns (or less if the game gets over), only updating
+ * what the player sees once at the end. */
+void fast_forward(int turn_number)
+{
+	assert(!g_fast_forwarding);
+	g_fast_forwarding = true;
+	for (int i = 0; i < turn_number && !(g_game_has_started && g_game_over); i++)
+	{
+		perform_turn();
+	}
+	g_fast_forwarding = false;
+
+	if (g_game_has_started)
+	{
+		uint64_t counter_begin = SDL_GetPerformanceCounter();
+		recompute_vision();
+		g_turn_phase_seconds_table[TURN_PHASE_VISION] += seconds_since(counter_begin);
 		log_turn_seperator();
 	}
 }
@@ -555,10 +584,6 @@ void draw_obj_da(oid_da_t* oid_da)
 	for (int i = 0; i < oid_da->len; i++)
 	{
 		oid_t oid = oid_da->arr[i];
-		if (oid_eq(oid, OID_NULL))
-		{
-			continue;
-		}
 		/* Draw a short text description of the object. */
 		draw_text_sc(obj_name(oid),
 			rgb_to_rgba(g_color_white, 255), FONT_RG, (sc_t){g_window_w - 200, y});
@@ -584,11 +609,57 @@ void draw_objects_on_same_tile_list(oid_t oid)
 	draw_obj_da(tile_oid_da);
 }
 
+/* Width and height of the map grid of the generated worlds. */
+int g_world_side = 100;
+
+/* Everything needed to perform turns, which does not need SDL to be initialized. */
+void generate_world(void)
+{
+	init_mg(g_world_side, g_world_side);
+
+	/* Before the map, as the laws may want to know about the objects created with it. */
+	register_laws();
+
+	printf("Generate materials\n");
+	generate_some_materials();
+	printf("Generate map\n");
+	generate_map();
+}
+
+void spawn_player(void)
+{
+	printf("Spawn player\n");
+	rng_begin_stream(rng_domain_key(RNG_DOMAIN_PLAYER_SPAWN));
+	/* Place the player on a tile that does not contains blocking objects. */
+	tc_t tc = {g_mg_rect.w / 2, g_mg_rect.h / 2};
+	while (get_tile(tc)->blocking_obj_count > 0)
+	{
+		tc_t new_tc = tc_add_tm(tc, rand_tm_one());
+		while (get_tile(new_tc) == NULL)
+		{
+			new_tc = tc_add_tm(tc, rand_tm_one());
+		}
+		tc = new_tc;
+	}
+	g_player_oid = obj_create(OBJ_PLAYER, tc_to_loc(tc),
+		10, rand_material(MATERIAL_TISSUE));
+
+	#warning TEST
+	obj_create(OBJ_MOSS, inside_obj_loc(g_player_oid),
+		10, rand_material(MATERIAL_VEGETAL));
+	oid_t moss_oid = obj_create(OBJ_MOSS, inside_obj_loc(g_player_oid),
+		10, rand_material(MATERIAL_VEGETAL));
+	obj_create(OBJ_GRASS, inside_obj_loc(moss_oid),
+		10, rand_material(MATERIAL_VEGETAL));
+	rng_end_stream();
+}
+
 void init_all(void)
 {
 	printf("Initialize stuff\n");
 
-	srand(time(NULL));
+	g_world_seed = time(NULL);
+	srand(g_world_seed);
 
 	if (SDL_Init(SDL_INIT_VIDEO) != 0)
 	{
@@ -630,61 +701,13 @@ void init_all(void)
 	g_font_table[FONT_TL_SMALL] = TTF_OpenFontRW(rwops_font, 0, 15);
 	assert(g_font_table[FONT_TL_SMALL] != NULL);
 
-	g_mg_rect.w = 100;
-	g_mg_rect.h = 100;
-	g_mg = malloc(g_mg_rect.w * g_mg_rect.h * sizeof(tile_t));
-
-	for (int y = 0; y < g_mg_rect.h; y++)
-	for (int x = 0; x < g_mg_rect.w; x++)
-	{
-		tc_t tc = {x, y};
-		tile_t* tile = get_tile(tc);
-		*tile = (tile_t){0};
-	}
-
-	printf("Generate materials\n");
-	generate_some_materials();
-	printf("Generate map\n");
-	generate_map();
-
-	register_laws();
+	generate_world();
 
 	printf("Perform some turns\n");
-	for (int i = 0; i < 200; i++)
-	{
-		perform_turn();
-
-		if (i % 50 == 0 && i > 0)
-		{
-			printf("Performing turns %d%%\n", (i * 100) / 200);
-		}
-	}
+	fast_forward(200);
 	printf("Performing turns done\n");
 
-	printf("Spawn player\n");
-	{
-		/* Place the player on a tile that does not contains blocking objects. */
-		tc_t tc = {g_mg_rect.w / 2, g_mg_rect.h / 2};
-		while (oid_da_contains_obj_f(&get_tile(tc)->oid_da, obj_is_blocking))
-		{
-			tc_t new_tc = tc_add_tm(tc, rand_tm_one());
-			while (get_tile(new_tc) == NULL)
-			{
-				new_tc = tc_add_tm(tc, rand_tm_one());
-			}
-			tc = new_tc;
-		}
-		g_player_oid = obj_create(OBJ_PLAYER, tc_to_loc(tc),
-			10, rand_material(MATERIAL_TISSUE));
-
-		#warning TEST
-		obj_create(OBJ_MOSS, inside_obj_loc(g_player_oid),
-			10, rand_material(MATERIAL_VEGETAL));
-		oid_t moss_oid = obj_create(OBJ_MOSS, inside_obj_loc(g_player_oid),
-			10, rand_material(MATERIAL_VEGETAL));
-		obj_create(OBJ_GRASS, inside_obj_loc(moss_oid),
-			10, rand_material(MATERIAL_VEGETAL));
-	}
+	spawn_player();
 	recompute_vision();
 	
 	camera_set(&g_camera, loc_to_tc(get_obj(g_player_oid)->loc));
@@ -741,19 +764,35 @@ int draw_object_list_recursively(oid_t oid, int y, int indent_level)
 	for (int i = 0; i < obj->attached_da.len; i++)
 	{
 		oid_t sub_oid = obj->attached_da.arr[i];
-		if (oid_eq(sub_oid, OID_NULL))
-		{
-			continue;
-		}
 		y = draw_object_list_recursively(sub_oid, y, indent_level + 1);
 	}
 
 	return y;
 }
 
+/* Draws the profiling counters of the laws, one law per line. */
+void draw_law_stats(sc_t sc)
+{
+	rgba_t const color = rgb_to_rgba(g_color_white, 255);
+	draw_text_sc("law: calls, acting calls, total time, time per call",
+		color, FONT_RG, sc);
+	for (int i = 0; i < g_law_da_len; i++)
+	{
+		sc.y += 30;
+		law_stats_t const* stats = &g_law_da[i].stats;
+		char text[256];
+		snprintf(text, sizeof text, "%s: %lld, %lld, %.3f ms, %.3f us",
+			g_law_da[i].name, stats->call_count, stats->acting_call_count,
+			stats->seconds * 1000.0,
+			stats->call_count > 0 ? stats->seconds / stats->call_count * 1000000.0 : 0.0);
+		draw_text_sc(text, color, FONT_RG, sc);
+	}
+}
+
 void internals_menu_game_state_draw_layer(void)
 {
 	draw_object_list_recursively(g_player_oid, 20, 0);
+	draw_law_stats((sc_t){800, 20});
 }
 
 void internals_menu_game_handle_input_event_direction(input_event_direction_t input_event_direction)
@@ -807,7 +846,7 @@ void base_game_state_draw_layer(void)
 			obj_t* player_obj = get_obj(g_player_oid);
 			if (player_obj != NULL)
 			{
-				char* text = format("HP: %d", get_obj(g_player_oid)->life);
+				char* text = format("HP: %d", obj_life(g_player_oid));
 				draw_text_sc(text,
 					rgb_to_rgba(g_color_white, 255), FONT_RG, (sc_t){10, y});
 				free(text);
@@ -859,6 +898,14 @@ void base_game_handle_input_event_letter_key(char letter)
 		case 'i':
 			push_game_state(internals_menu_game_state);
 		break;
+		case 'r':
+			/* Rest for a while. */
+			if (!g_game_over)
+			{
+				log_text("Resting.");
+				fast_forward(10);
+			}
+		break;
 	}
 }
 
@@ -898,6 +945,11 @@ void base_game_handle_input_event_debugging_letter_key(char letter)
 				}
 			}
 		break;
+		case 't':
+			/* Skip some time. */
+			log_text("Skipping 100 turns.");
+			fast_forward(100);
+		break;
 		case 'o':
 			/* Produce some moss. */
 			{
@@ -924,8 +976,154 @@ game_state_t base_game_state = {
 	.handle_input_event_debugging_letter_key =
 		base_game_handle_input_event_debugging_letter_key};
 
-int main(void)
+/* Writes the profiling counters of the laws as CSV, one law per line. */
+void write_law_stats_csv(char const* path)
+{
+	FILE* file = fopen(path, "w");
+	if (file == NULL)
+	{
+		printf("Could not open \"%s\" to write the law stats\n", path);
+		return;
+	}
+	fprintf(file, "law,calls,acting_calls,seconds\n");
+	for (int i = 0; i < g_law_da_len; i++)
+	{
+		law_stats_t const* stats = &g_law_da[i].stats;
+		fprintf(file, "%s,%lld,%lld,%.9f\n", g_law_da[i].name,
+			stats->call_count, stats->acting_call_count, stats->seconds);
+	}
+	fclose(file);
+	printf("Wrote the law stats to \"%s\"\n", path);
+}
+
+/* Runs the simulation for the given number of turns without any window or font,
+ * then reports the throughput, the objects and where the time went. */
+void run_headless(int turn_number, unsigned int seed, char const* law_stats_csv_path)
 {
+	printf("Run %d turns headless with seed %u on a %dx%d map and %d law threads%s\n",
+		turn_number, seed, g_world_side, g_world_side, g_law_thread_number,
+		g_law_double_buffered ? " (double-buffered)" : "");
+	g_world_seed = seed;
+	srand(seed);
+	generate_world();
+	if (g_law_lod_radius > 0)
+	{
+		/* The level of detail of the simulation depends on where the player is, and
+		 * stays centered on where it was spawned (nobody plays it, so it may die early). */
+		spawn_player();
+		g_law_lod_center_is_fixed = true;
+		g_law_lod_center_tc = loc_to_tc(get_obj(g_player_oid)->loc);
+	}
+	printf("Object count after generation: %d\n", g_obj_count);
+
+	uint64_t counter_begin = SDL_GetPerformanceCounter();
+	fast_forward(turn_number);
+	double seconds = seconds_since(counter_begin);
+
+	printf("Performed %d turns in %.3f s: %.2f turns per second\n",
+		turn_number, seconds, (double)turn_number / seconds);
+
+	int obj_count_table[OBJ_TYPE_NUMBER] = {0};
+	oid_t oid = OID_NULL;
+	while (oid_iter(&oid))
+	{
+		obj_count_table[obj_type(oid)]++;
+	}
+	printf("Object count at the end: %d\n", g_obj_count);
+	for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+	{
+		printf("  %-12s %8d\n", obj_type_name(type), obj_count_table[type]);
+	}
+
+	printf("Time per phase:\n");
+	for (int phase = 0; phase < TURN_PHASE_NUMBER; phase++)
+	{
+		double const phase_seconds = g_turn_phase_seconds_table[phase];
+		printf("  %-12s %10.3f ms %6.2f %%\n", turn_phase_name(phase),
+			phase_seconds * 1000.0, seconds > 0.0 ? phase_seconds / seconds * 100.0 : 0.0);
+	}
+
+	printf("Time per law:\n");
+	for (int i = 0; i < g_law_da_len; i++)
+	{
+		law_stats_t const* stats = &g_law_da[i].stats;
+		printf("  %-28s %10lld calls %10lld acting %10.3f ms\n", g_law_da[i].name,
+			stats->call_count, stats->acting_call_count, stats->seconds * 1000.0);
+	}
+	if (law_stats_csv_path != NULL)
+	{
+		write_law_stats_csv(law_stats_csv_path);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int headless_turn_number = -1;
+	bool seed_is_fixed = false;
+	unsigned int seed = 0;
+	char const* law_stats_csv_path = NULL;
+	/* The outcome of the turns does not depend on it. */
+	g_law_thread_number = SDL_GetCPUCount();
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bench-obj-table") == 0)
+		{
+			bench_obj_table();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-vision") == 0)
+		{
+			bench_vision();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-vision-observers") == 0)
+		{
+			bench_vision_observers();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--headless") == 0 && i+1 < argc)
+		{
+			headless_turn_number = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--law-threads") == 0 && i+1 < argc)
+		{
+			g_law_thread_number = max(1, atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i+1 < argc)
+		{
+			seed = strtoul(argv[++i], NULL, 10);
+			seed_is_fixed = true;
+		}
+		else if (strcmp(argv[i], "--law-stats-csv") == 0 && i+1 < argc)
+		{
+			law_stats_csv_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--double-buffered-laws") == 0)
+		{
+			g_law_double_buffered = true;
+		}
+		else if (strcmp(argv[i], "--lod-radius") == 0 && i+1 < argc)
+		{
+			g_law_lod_radius = max(0, atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--map-side") == 0 && i+1 < argc)
+		{
+			g_world_side = max(32, atoi(argv[++i]));
+		}
+		else
+		{
+			printf("Unknown command line argument \"%s\"\n", argv[i]);
+			return 1;
+		}
+	}
+
+	if (headless_turn_number >= 0)
+	{
+		run_headless(headless_turn_number, seed_is_fixed ? seed : (unsigned int)time(NULL),
+			law_stats_csv_path);
+		return 0;
+	}
+
 	main_start:
 
 	init_all();
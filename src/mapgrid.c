@@ -1,12 +1,13 @@
 
 #include "mapgrid.h"
 #include <stdlib.h>
+#include <assert.h>
 
 tile_t* get_tile(tc_t tc)
 {
 	if (tc_in_rect(tc, g_mg_rect))
 	{
-		return &g_mg[tc.y * g_mg_rect.w + tc.x];
+		return &g_mg[tile_index(tc)];
 	}
 	else
 	{
@@ -14,5 +15,68 @@ tile_t* get_tile(tc_t tc)
 	}
 }
 
+int tile_index(tc_t tc)
+{
+	assert(tc_in_rect(tc, g_mg_rect));
+	return (tc.y - g_mg_rect.y) * g_mg_rect.w + (tc.x - g_mg_rect.x);
+}
+
+tc_t tile_index_to_tc(int index)
+{
+	return (tc_t){g_mg_rect.x + index % g_mg_rect.w, g_mg_rect.y + index / g_mg_rect.w};
+}
+
+int get_tile_vision(tc_t tc)
+{
+	if (tc_in_rect(tc, g_mg_rect))
+	{
+		return g_mg_vision_arr[tile_index(tc)];
+	}
+	else
+	{
+		return 0;
+	}
+}
+
 tile_t* g_mg = NULL;
 tc_rect_t g_mg_rect = {0, 0, -1, -1};
+unsigned int g_mg_generation = 0;
+uint8_t* g_mg_vision_cost_arr = NULL;
+uint8_t* g_mg_vision_arr = NULL;
+uint8_t* g_mg_vision_is_dirty_arr = NULL;
+
+void init_mg(int w, int h)
+{
+	g_mg_rect = (tc_rect_t){0, 0, w, h};
+	g_mg = malloc(g_mg_rect.w * g_mg_rect.h * sizeof(tile_t));
+	assert(g_mg != NULL);
+
+	for (int y = 0; y < g_mg_rect.h; y++)
+	for (int x = 0; x < g_mg_rect.w; x++)
+	{
+		tc_t tc = {x, y};
+		tile_t* tile = get_tile(tc);
+		*tile = (tile_t){0};
+	}
+
+	int const tile_number = g_mg_rect.w * g_mg_rect.h;
+	g_mg_vision_cost_arr = calloc(tile_number, 1);
+	g_mg_vision_arr = calloc(tile_number, 1);
+	g_mg_vision_is_dirty_arr = calloc(tile_number, 1);
+	assert(g_mg_vision_cost_arr != NULL && g_mg_vision_arr != NULL &&
+		g_mg_vision_is_dirty_arr != NULL);
+	g_mg_generation++;
+}
+
+void free_mg(void)
+{
+	free(g_mg);
+	g_mg = NULL;
+	free(g_mg_vision_cost_arr);
+	g_mg_vision_cost_arr = NULL;
+	free(g_mg_vision_arr);
+	g_mg_vision_arr = NULL;
+	free(g_mg_vision_is_dirty_arr);
+	g_mg_vision_is_dirty_arr = NULL;
+	g_mg_generation++;
+}
@@ -5,19 +5,53 @@
 #include "objects.h"
 #include "tc.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 struct tile_t
 {
 	oid_da_t oid_da;
+	/* Aggregates over the objects of `oid_da`, kept up to date when objects are placed
+	 * on or removed from the tile, so that frequent queries do not have to go through
+	 * all the objects of the tile. */
+	int blocking_obj_count; /* Number of objects that are `obj_is_blocking`. */
+	int hittable_obj_count; /* Number of objects that are `obj_can_get_hit_for_now`. */
+	int vision_blocking_sum; /* Sum of the `obj_vision_blocking` of the objects. */
 	bool is_path;
-	int vision;
 };
 typedef struct tile_t tile_t;
 
 tile_t* get_tile(tc_t tc);
 
+/* Index in the map grid (and in its planes) of the given tile, that must be in it,
+ * and the other way around. */
+int tile_index(tc_t tc);
+tc_t tile_index_to_tc(int index);
+
 /* Map grid. */
 extern tile_t* g_mg;
 extern tc_rect_t g_mg_rect;
+/* Incremented every time the map grid is allocated or freed, so that what keeps state
+ * about it can tell that it is not the same one anymore (even if it has the same address
+ * and dimensions as the previous one). */
+extern unsigned int g_mg_generation;
+
+/* Planes of the map grid, indexed like `g_mg`, that hold one byte per tile (instead of
+ * being fields of `tile_t`) so that the passes over whole rows of them are plain loops
+ * over contiguous bytes, which the compiler vectorizes. */
+/* The `vision_blocking_sum` of the tiles, capped at `UINT8_MAX` (that is way more
+ * than enough to block any vision), kept up to date with it. */
+extern uint8_t* g_mg_vision_cost_arr;
+/* How well the tiles are seen by the player (see `vision_compute`). */
+extern uint8_t* g_mg_vision_arr;
+/* Set when the `vision_blocking_sum` of a tile that is seen changes, so that
+ * `vision_compute` knows what it has to compute again. */
+extern uint8_t* g_mg_vision_is_dirty_arr;
+
+/* The vision of the given tile (see `g_mg_vision_arr`), 0 if it is not in the map grid. */
+int get_tile_vision(tc_t tc);
+
+/* Allocates the map grid with the given dimensions, all its tiles being empty. */
+void init_mg(int w, int h);
+void free_mg(void);
 
 #endif /* WHYCRYSTALS_HEADER_MAPGRID_ */
@@ -2,6 +2,7 @@
 #include "materials.h"
 #include "utils.h"
 #include "log.h"
+#include "rng.h"
 #include <stdlib.h>
 #include <assert.h>
 
@@ -19,13 +20,13 @@ char const* material_type_name(material_type_t type)
 
 char* generate_name(void)
 {
-	int pair_number = 1 + (rand() % 2) + (rand() % 20 == 0 ? 1 : 0);
+	int pair_number = 1 + (rng_rand() % 2) + (rng_rand() % 20 == 0 ? 1 : 0);
 	char* name = malloc(2 * pair_number + 1);
 	name[2 * pair_number] = '\0';
 	for (int i = 0; i < pair_number; i ++)
 	{
-		name[2 * i + 0] = "zrtpqsdfghjklmwxcvbn"[rand() % 20];
-		name[2 * i + 1] = "aeyuio"[rand() % 6];
+		name[2 * i + 0] = "zrtpqsdfghjklmwxcvbn"[rng_rand() % 20];
+		name[2 * i + 1] = "aeyuio"[rng_rand() % 6];
 	}
 	return name;
 }
@@ -38,41 +39,44 @@ material_id_t generate_material(material_type_t type)
 	DA_LENGTHEN(g_material_da_len += 1,
 		g_material_da_cap, g_material_da, material_t);
 	material_id_t id = g_material_da_len-1;
+	rng_begin_stream(rng_key(rng_domain_key(RNG_DOMAIN_MATERIAL), id));
 
-	char* name = rand() % 2 == 0 ?
+	char* name = rng_rand() % 2 == 0 ?
 		format("%s %d", material_type_name(type), id) :
 		format("%s %s", material_type_name(type), generate_name());
 
 	rgb_t colors[2] = {
-		{rand() % 255, rand() % 255, rand() % 255},
-		{rand() % 255, rand() % 255, rand() % 255}};
+		{rng_rand() % 255, rng_rand() % 255, rng_rand() % 255},
+		{rng_rand() % 255, rng_rand() % 255, rng_rand() % 255}};
 	for (int i = 0; i < 2; i++)
 	{
 		switch (type)
 		{
 			case MATERIAL_HARD:
-				((uint8_t*)&colors[i])[rand() % 3] = (255 - 40) + rand() % 40;;
+				((uint8_t*)&colors[i])[rng_rand() % 3] = (255 - 40) + rng_rand() % 40;;
 			break;
 			case MATERIAL_VEGETAL:
-				colors[i].r = rand() % 120;
-				colors[i].g = (255 - 40) + rand() % 40;
-				colors[i].b = rand() % 120;
+				colors[i].r = rng_rand() % 120;
+				colors[i].g = (255 - 40) + rng_rand() % 40;
+				colors[i].b = rng_rand() % 120;
 			break;
 			case MATERIAL_TISSUE:
-				colors[i].r = (255 - 100) + rand() % 100;
-				colors[i].g = (255 - 100) + rand() % 100;
-				colors[i].b = (255 - 100) + rand() % 100;
-				((uint8_t*)&colors[i])[rand() % 3] = 0;
+				colors[i].r = (255 - 100) + rng_rand() % 100;
+				colors[i].g = (255 - 100) + rng_rand() % 100;
+				colors[i].b = (255 - 100) + rng_rand() % 100;
+				((uint8_t*)&colors[i])[rng_rand() % 3] = 0;
 			break;
 			case MATERIAL_LIQUID:
-				colors[i].r = (255 - 80) + rand() % 80;
-				colors[i].g = (255 - 80) + rand() % 80;
-				colors[i].b = (255 - 80) + rand() % 80;
-				((uint8_t*)&colors[i])[rand() % 3] = rand() % 80;
+				colors[i].r = (255 - 80) + rng_rand() % 80;
+				colors[i].g = (255 - 80) + rng_rand() % 80;
+				colors[i].b = (255 - 80) + rng_rand() % 80;
+				((uint8_t*)&colors[i])[rng_rand() % 3] = rng_rand() % 80;
 			break;
 		}
 	}
 
+	rng_end_stream();
+
 	g_material_da[id] = (material_t){
 		.name = name,
 		.type = type,
@@ -116,10 +120,10 @@ material_t* get_material(material_id_t id)
 material_id_t rand_material(material_type_t type)
 {
 	assert(g_material_da_len > 0);
-	material_id_t material_id = rand() % g_material_da_len;
+	material_id_t material_id = rng_rand() % g_material_da_len;
 	while (get_material(material_id)->type != type)
 	{
-		material_id = rand() % g_material_da_len;
+		material_id = rng_rand() % g_material_da_len;
 	}
 	return material_id;
 }
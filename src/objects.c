@@ -4,7 +4,9 @@
 #include "utils.h"
 #include "log.h"
 #include <limits.h>
+#include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 /* Section `oid_t`. */
 
@@ -59,6 +61,9 @@ char* loc_to_text_allocated(loc_t loc)
 	}
 }
 
+/* Defined in the section `obj_t`. */
+static obj_t* get_obj_even_dying(oid_t oid);
+
 tc_t loc_to_tc(loc_t loc)
 {
 	switch (loc.type)
@@ -66,8 +71,10 @@ tc_t loc_to_tc(loc_t loc)
 		case LOC_TILE:
 			return loc.tile.tc;
 		case LOC_ATTACHED_TO_OBJ:
-			assert(get_obj(loc.attached_to_obj.oid) != NULL);
-			return loc_to_tc(get_obj(loc.attached_to_obj.oid)->loc);
+			/* The container may be dying, in which case it kept its last location
+			 * which is where its subobjects are to end up anyway. */
+			assert(get_obj_even_dying(loc.attached_to_obj.oid) != NULL);
+			return loc_to_tc(get_obj_even_dying(loc.attached_to_obj.oid)->loc);
 		default:
 			assert(false); exit(EXIT_FAILURE);
 	}
@@ -117,18 +124,35 @@ void visual_effect_obj_da_remove(visual_effect_obj_da_t* da, int index)
 
 void oid_da_add(oid_da_t* da, oid_t oid)
 {
-	/* Try inserting in a free spot. */
-	for (int i = 0; i < da->len; i++)
+	assert(!oid_eq(oid, OID_NULL));
+	if (da->arr == NULL)
 	{
-		if (oid_eq(da->arr[i], OID_NULL))
+		da->arr = da->inline_arr;
+		da->cap = OID_DA_INLINE_CAP;
+	}
+	if (da->len == da->cap)
+	{
+		/* Spill to the heap (or grow the heap array if it is already there). */
+		int const new_cap = max(da->len + 1, ((float)da->cap + 2.3f) * 1.3f);
+		oid_t* new_arr;
+		if (da->arr == da->inline_arr)
 		{
-			da->arr[i] = oid;
-			return;
+			new_arr = malloc(new_cap * sizeof(oid_t));
+			assert(new_arr != NULL);
+			for (int i = 0; i < da->len; i++)
+			{
+				new_arr[i] = da->inline_arr[i];
+			}
+		}
+		else
+		{
+			new_arr = realloc(da->arr, new_cap * sizeof(oid_t));
+			assert(new_arr != NULL);
 		}
+		da->arr = new_arr;
+		da->cap = new_cap;
 	}
-	/* No free spot, extend the dynamic array. */
-	DA_LENGTHEN(da->len += 1, da->cap, da->arr, oid_t);
-	da->arr[da->len-1] = oid;
+	da->arr[da->len++] = oid;
 }
 
 void oid_da_remove(oid_da_t* da, oid_t oid)
@@ -137,52 +161,358 @@ void oid_da_remove(oid_da_t* da, oid_t oid)
 	{
 		if (oid_eq(da->arr[i], oid))
 		{
-			da->arr[i] = OID_NULL;
+			/* Fill the hole with the last element, the order does not matter. */
+			da->arr[i] = da->arr[da->len-1];
+			da->len--;
+			return;
 		}
 	}
 }
 
-/* Section `obj_t`. */
-
-char const* obj_type_name(obj_type_t type)
+void oid_da_cleanup(oid_da_t* da)
 {
-	switch (type)
+	if (da->arr != da->inline_arr)
 	{
-		case OBJ_PLAYER:      return "player";
-		case OBJ_CRYSTAL:     return "crystal";
-		case OBJ_ROCK:        return "rock";
-		case OBJ_GRASS:       return "grass";
-		case OBJ_BUSH:        return "bush";
-		case OBJ_MOSS:        return "moss";
-		case OBJ_TREE:        return "tree";
-		case OBJ_SEED:        return "seed";
-		case OBJ_SLIME:       return "slime";
-		case OBJ_CATERPILLAR: return "caterpillar";
-		case OBJ_EGG:         return "egg";
-		case OBJ_LIQUID:      return "liquid";
-		default:              assert(false); exit(EXIT_FAILURE);
+		free(da->arr);
 	}
+	*da = (oid_da_t){0};
 }
 
+/* Section `obj_t`. */
+
+/* Kinds of lists of entries an entry can be in (see `obj_index_list_t`). */
+enum obj_list_kind_t
+{
+	/* List of the entries of all the objects. */
+	OBJ_LIST_OF_ALL,
+	/* List of the entries of the objects of a given type. */
+	OBJ_LIST_OF_TYPE,
+	/* List of the entries of the awake objects. */
+	OBJ_LIST_OF_AWAKE,
+
+	OBJ_LIST_KIND_NUMBER
+};
+typedef enum obj_list_kind_t obj_list_kind_t;
+
 struct obj_entry_t
 {
 	bool used;
+	/* The object was destroyed while the destruction of objects was deferred,
+	 * it is not used anymore but the entry is not released yet
+	 * (see `begin_deferred_obj_destruction`). */
+	bool dying;
+	/* The object is in the list of the awake objects (see `obj_wake`). */
+	bool awake;
 	int generation;
-	obj_t* obj;
+	/* Position of the entry in each of the lists of entries it is in
+	 * (see `obj_index_list_t`), indexed by `obj_list_kind_t`. */
+	int list_pos_table[OBJ_LIST_KIND_NUMBER];
+	/* The object is stored inline, its memory is recycled when the entry is reused. */
+	obj_t obj;
 };
 typedef struct obj_entry_t obj_entry_t;
 
-/* The global dynamic array of objects.
+/* The entries are stored in fixed-size pages that never move once allocated
+ * (unlike the elements of a dynamic array that may be moved by a `realloc`),
+ * so that pointers to objects remain valid when other objects are created. */
+#define OBJ_PAGE_SIZE_LOG2 10
+#define OBJ_PAGE_SIZE (1 << OBJ_PAGE_SIZE_LOG2)
+
+/* The global table of objects.
  * All objects should be stored in there. */
-static obj_entry_t* g_obj_da;
-static int g_obj_da_len, g_obj_da_cap;
+static obj_entry_t** g_obj_page_da;
+static int g_obj_page_da_len, g_obj_page_da_cap;
+/* Number of entries (used or not) in the global table of objects. */
+static int g_obj_entry_number;
+
+/* Indices of all the unused entries of the table, used as a stack, so that finding
+ * an entry for a new object does not require any searching (and so that taking
+ * a bunch of them, see `obj_reserve`, is a copy). */
+static int* g_obj_free_index_da = NULL;
+static int g_obj_free_index_da_len = 0, g_obj_free_index_da_cap = 0;
+
+/* Entries of objects destroyed while iterating over objects are not made free right
+ * away (so that they are not reused and their list positions remain valid for the
+ * ongoing iterations), they are kept in there instead, and made free when the iterations
+ * are done. */
+static int* g_obj_pending_free_index_da = NULL;
+static int g_obj_pending_free_index_da_len = 0, g_obj_pending_free_index_da_cap = 0;
+
+/* Is the destruction of objects currently deferred (see `begin_deferred_obj_destruction`). */
+static bool g_obj_destruction_is_deferred = false;
+/* Indices of the dying entries, released all at once by `end_deferred_obj_destruction`. */
+static int* g_obj_dying_index_da = NULL;
+static int g_obj_dying_index_da_len = 0, g_obj_dying_index_da_cap = 0;
+
+obj_type_set_t g_obj_recorded_creation_type_set = 0;
+/* The objects of the recorded types created since the last `obj_flush_created`. */
+static oid_t* g_obj_created_oid_da = NULL;
+static int g_obj_created_oid_da_len = 0, g_obj_created_oid_da_cap = 0;
+
+/* Objects may be created and destroyed by several threads at once (see `apply_laws`),
+ * this protects what is shared by all the objects (the free list, the lists of entries,
+ * the dying entries and the object count). */
+static pthread_mutex_t g_obj_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* The reservation that the objects created by the current thread take their entry from,
+ * if any (see `obj_set_thread_reservation`). */
+static _Thread_local obj_reservation_t* t_obj_reservation = NULL;
+
+/* See `obj_thread_change_count`. */
+static _Thread_local unsigned int t_obj_change_count = 0;
+
+static inline obj_entry_t* get_entry(int index)
+{
+	return &g_obj_page_da[index >> OBJ_PAGE_SIZE_LOG2][index & (OBJ_PAGE_SIZE - 1)];
+}
+
+/* The hot fields of the objects, stored as parallel arrays indexed by `oid_t.index`
+ * (with a length of `g_obj_entry_number`), so that loops over all the objects
+ * that only touch some of these fields are tight loops over contiguous memory.
+ * Unlike the pages, these arrays may be moved when they grow, which is not a problem
+ * as they are only ever accessed via indices. */
+static obj_type_t* g_obj_type_arr;
+static int* g_obj_life_arr;
+static int* g_obj_max_life_arr;
+static int* g_obj_age_arr;
+static material_id_t* g_obj_material_id_arr;
+static int g_obj_hot_arr_cap;
+
+static void obj_hot_arrs_lengthen(int len)
+{
+	if (len > g_obj_hot_arr_cap)
+	{
+		int const new_cap = max(len, ((float)g_obj_hot_arr_cap + 2.3f) * 1.3f);
+		#define OBJ_HOT_ARR_REALLOC(arr_) \
+			do { \
+				void* new_arr = realloc(arr_, new_cap * sizeof arr_[0]); \
+				assert(new_arr != NULL); \
+				arr_ = new_arr; \
+			} while (0)
+		OBJ_HOT_ARR_REALLOC(g_obj_type_arr);
+		OBJ_HOT_ARR_REALLOC(g_obj_life_arr);
+		OBJ_HOT_ARR_REALLOC(g_obj_max_life_arr);
+		OBJ_HOT_ARR_REALLOC(g_obj_age_arr);
+		OBJ_HOT_ARR_REALLOC(g_obj_material_id_arr);
+		#undef OBJ_HOT_ARR_REALLOC
+		g_obj_hot_arr_cap = new_cap;
+	}
+}
 
 int g_obj_count = 0;
+/* Number of objects of each type, indexed by `obj_type_t`. */
+static int g_obj_type_count_table[OBJ_TYPE_NUMBER];
+
+/* A list of the indices of some used entries, in no particular order.
+ * Each entry knows its position in the lists it is in (in `list_pos_table`),
+ * which allows for removal in constant time (by moving the last element of the list
+ * into the hole). While objects are being iterated over, removals leave a hole instead
+ * (so that elements do not move under the feet of the iterators), and the lists are
+ * compacted when the iterations are done. A hole is negative and remembers the entry
+ * that was there (see `obj_index_list_hole`), so that an entry added back before the
+ * compaction gets its old position back. */
+struct obj_index_list_t
+{
+	int* arr;
+	int len, cap;
+};
+typedef struct obj_index_list_t obj_index_list_t;
+
+/* List of the entries of all the objects, so that iterating over all of them
+ * or picking one at random does not involve going through unused entries. */
+static obj_index_list_t g_obj_live_list;
+/* List of the entries of the objects of each type, indexed by `obj_type_t`. */
+static obj_index_list_t g_obj_type_list_table[OBJ_TYPE_NUMBER];
+/* List of the entries of the awake objects, so that the laws only look at these. */
+static obj_index_list_t g_obj_awake_list;
+
+obj_type_set_t g_obj_wakeable_type_set = 0;
+
+/* Number of ongoing iterations over objects (see `oid_iter`). */
+static int g_obj_iter_depth = 0;
+/* Do some lists contain holes that are waiting for the iterations to be done ? */
+static bool g_obj_lists_have_holes = false;
+
+/* The hole left by the removal of the given entry during iterations. */
+static int obj_index_list_hole(int index)
+{
+	return -1 - index;
+}
+
+static void obj_index_list_add(obj_index_list_t* list, obj_list_kind_t kind, int index)
+{
+	/* An entry removed during the ongoing iterations (like an object put to sleep and then
+	 * woken up) is put back where it was, as an iteration that was at it goes on from
+	 * its position and would skip the elements in between if it moved to the end. */
+	int const pos = get_entry(index)->list_pos_table[kind];
+	if (g_obj_iter_depth > 0 && 0 <= pos && pos < list->len &&
+		list->arr[pos] == obj_index_list_hole(index))
+	{
+		list->arr[pos] = index;
+		return;
+	}
+	DA_LENGTHEN(list->len += 1, list->cap, list->arr, int);
+	list->arr[list->len-1] = index;
+	get_entry(index)->list_pos_table[kind] = list->len-1;
+}
+
+static void obj_index_list_remove(obj_index_list_t* list, obj_list_kind_t kind, int index)
+{
+	int const pos = get_entry(index)->list_pos_table[kind];
+	assert(0 <= pos && pos < list->len && list->arr[pos] == index);
+	if (g_obj_iter_depth > 0)
+	{
+		list->arr[pos] = obj_index_list_hole(index);
+		g_obj_lists_have_holes = true;
+	}
+	else
+	{
+		int const last_index = list->arr[list->len-1];
+		list->arr[pos] = last_index;
+		get_entry(last_index)->list_pos_table[kind] = pos;
+		list->len--;
+	}
+}
+
+static void obj_index_list_compact(obj_index_list_t* list, obj_list_kind_t kind)
+{
+	int pos = 0;
+	while (pos < list->len)
+	{
+		if (list->arr[pos] < 0)
+		{
+			/* Fill the hole with the last element, that is then checked in turn. */
+			list->len--;
+			list->arr[pos] = list->arr[list->len];
+			if (pos < list->len && list->arr[pos] >= 0)
+			{
+				get_entry(list->arr[pos])->list_pos_table[kind] = pos;
+			}
+		}
+		else
+		{
+			pos++;
+		}
+	}
+}
+
+/* Called when all the ongoing iterations over objects are done, it gets rid of the holes
+ * in the lists and makes the entries of the objects destroyed in the meantime reusable. */
+static void obj_iterations_done(void)
+{
+	assert(g_obj_iter_depth == 0);
+	if (g_obj_lists_have_holes)
+	{
+		obj_index_list_compact(&g_obj_live_list, OBJ_LIST_OF_ALL);
+		for (int type = 0; type < OBJ_TYPE_NUMBER; type++)
+		{
+			obj_index_list_compact(&g_obj_type_list_table[type], OBJ_LIST_OF_TYPE);
+		}
+		obj_index_list_compact(&g_obj_awake_list, OBJ_LIST_OF_AWAKE);
+		g_obj_lists_have_holes = false;
+	}
+	if (g_obj_pending_free_index_da_len > 0)
+	{
+		int const len = g_obj_free_index_da_len;
+		DA_LENGTHEN(g_obj_free_index_da_len += g_obj_pending_free_index_da_len,
+			g_obj_free_index_da_cap, g_obj_free_index_da, int);
+		memcpy(&g_obj_free_index_da[len], g_obj_pending_free_index_da,
+			g_obj_pending_free_index_da_len * sizeof(int));
+		g_obj_pending_free_index_da_len = 0;
+	}
+}
+
+/* Adds (if `sign` is 1) or removes (if `sign` is -1) the contribution of the given object
+ * to the aggregates of the given tile (see `tile_t`). */
+static void tile_account_obj(tile_t* tile, oid_t oid, int sign)
+{
+	obj_type_t const type = obj_type(oid);
+	tile->blocking_obj_count += obj_type_is_blocking(type) ? sign : 0;
+	tile->hittable_obj_count += obj_type_can_get_hit_for_now(type) ? sign : 0;
+	tile->vision_blocking_sum += sign * obj_type_vision_blocking(type);
+	if (obj_type_vision_blocking(type) != 0)
+	{
+		int const tile_index = tile - g_mg;
+		g_mg_vision_cost_arr[tile_index] = min(tile->vision_blocking_sum, UINT8_MAX);
+		if (g_mg_vision_arr[tile_index] > 0)
+		{
+			g_mg_vision_is_dirty_arr[tile_index] = true;
+		}
+	}
+	assert(tile->blocking_obj_count >= 0 && tile->hittable_obj_count >= 0);
+}
+
+void obj_wake(oid_t oid)
+{
+	/* Most objects are of types that never wake, which is checked first
+	 * (the type of an unused entry may be anything, but then it is not used). */
+	if ((g_obj_wakeable_type_set & OBJ_TYPE_SET(g_obj_type_arr[oid.index])) == 0)
+	{
+		return;
+	}
+	obj_entry_t* entry = get_entry(oid.index);
+	if (!entry->awake && entry->used && entry->generation == oid.generation)
+	{
+		pthread_mutex_lock(&g_obj_table_mutex);
+		obj_index_list_add(&g_obj_awake_list, OBJ_LIST_OF_AWAKE, oid.index);
+		entry->awake = true;
+		pthread_mutex_unlock(&g_obj_table_mutex);
+	}
+}
+
+void obj_sleep(oid_t oid)
+{
+	obj_entry_t* entry = get_entry(oid.index);
+	assert(entry->used && entry->generation == oid.generation);
+	if (entry->awake)
+	{
+		pthread_mutex_lock(&g_obj_table_mutex);
+		obj_index_list_remove(&g_obj_awake_list, OBJ_LIST_OF_AWAKE, oid.index);
+		entry->awake = false;
+		pthread_mutex_unlock(&g_obj_table_mutex);
+	}
+}
+
+/* Wakes the objects on the given tile and on the tiles next to it,
+ * as something changed there. */
+static void obj_wake_around(tc_t tc)
+{
+	for (int i = 0; i < 5; i++)
+	{
+		tile_t* tile = get_tile(i == 4 ? tc : tc_add_tm(tc, TM_ONE_ALL[i]));
+		if (tile == NULL)
+		{
+			continue;
+		}
+		for (int j = 0; j < tile->oid_da.len; j++)
+		{
+			obj_wake(tile->oid_da.arr[j]);
+		}
+	}
+}
+
+/* Where the subobjects of a dying object have to go, which is where the dying object was
+ * unless it was itself in a dying container (and so on). */
+static loc_t dying_obj_final_loc(obj_t const* obj)
+{
+	loc_t loc = obj->loc;
+	while (loc.type == LOC_ATTACHED_TO_OBJ)
+	{
+		obj_entry_t* container_entry = get_entry(loc.attached_to_obj.oid.index);
+		if (!container_entry->dying)
+		{
+			break;
+		}
+		loc = container_entry->obj.loc;
+	}
+	return loc;
+}
 
 static void obj_set_loc(oid_t oid, loc_t loc)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
+	t_obj_change_count++;
 	assert(obj->loc.type == LOC_NONE
 		/* This function does not removes properly the object from its previous location
 		 * as this is the job of `obj_unset_loc`. The object is thus expected to be nowhere,
@@ -190,12 +520,29 @@ static void obj_set_loc(oid_t oid, loc_t loc)
 	switch (loc.type)
 	{
 		case LOC_TILE:
-			oid_da_add(&get_tile(loc_to_tc(loc))->oid_da, oid);
-			obj->loc = loc;
+			{
+				tile_t* tile = get_tile(loc_to_tc(loc));
+				oid_da_add(&tile->oid_da, oid);
+				tile_account_obj(tile, oid, 1);
+				obj->loc = loc;
+				obj_wake_around(loc_to_tc(loc));
+			}
 		break;
 		case LOC_ATTACHED_TO_OBJ:
+			if (get_entry(loc.attached_to_obj.oid.index)->dying)
+			{
+				/* Being put in a dying container (like a subobject of a dying object
+				 * creating something where it is) amounts to being put where the
+				 * container was, as this is where its subobjects are going anyway. */
+				obj_t* container = get_obj_even_dying(loc.attached_to_obj.oid);
+				assert(container != NULL);
+				obj_set_loc(oid, dying_obj_final_loc(container));
+				return;
+			}
 			oid_da_add(&get_obj(loc.attached_to_obj.oid)->attached_da, oid);
 			obj->loc = loc;
+			obj_wake(oid);
+			obj_wake(loc.attached_to_obj.oid);
 		break;
 		default:
 			assert(false); exit(EXIT_FAILURE);
@@ -206,6 +553,7 @@ static void obj_unset_loc(oid_t oid)
 {
 	obj_t* obj = get_obj(oid);
 	assert(obj != NULL);
+	t_obj_change_count++;
 	assert(obj->loc.type != LOC_NONE
 		/* It should not make sense to unset the location of on object
 		 * that does not have a location ? I mean... It if ever happens
@@ -213,11 +561,18 @@ static void obj_unset_loc(oid_t oid)
 	switch (obj->loc.type)
 	{
 		case LOC_TILE:
-			oid_da_remove(&get_tile(loc_to_tc(obj->loc))->oid_da, oid);
-			obj->loc = (loc_t){.type = LOC_NONE};
+			{
+				tile_t* tile = get_tile(loc_to_tc(obj->loc));
+				oid_da_remove(&tile->oid_da, oid);
+				tile_account_obj(tile, oid, -1);
+				obj_wake_around(loc_to_tc(obj->loc));
+				obj->loc = (loc_t){.type = LOC_NONE};
+			}
 		break;
 		case LOC_ATTACHED_TO_OBJ:
-			oid_da_remove(&get_obj(obj->loc.attached_to_obj.oid)->attached_da, oid);
+			/* Subobjects of a dying container can still be moved out of it. */
+			oid_da_remove(&get_obj_even_dying(obj->loc.attached_to_obj.oid)->attached_da, oid);
+			obj_wake(obj->loc.attached_to_obj.oid);
 			obj->loc = (loc_t){.type = LOC_NONE};
 		break;
 		default:
@@ -225,39 +580,119 @@ static void obj_unset_loc(oid_t oid)
 	}
 }
 
+/* Extends the table with one more entry, and makes it free. */
+static void obj_add_free_entry(void)
+{
+	/* With a new page if the last one is full. */
+	assert(g_obj_entry_number < INT_MAX);
+	if (g_obj_entry_number == g_obj_page_da_len * OBJ_PAGE_SIZE)
+	{
+		DA_LENGTHEN(g_obj_page_da_len += 1, g_obj_page_da_cap, g_obj_page_da, obj_entry_t*);
+		g_obj_page_da[g_obj_page_da_len-1] = calloc(OBJ_PAGE_SIZE, sizeof(obj_entry_t));
+		assert(g_obj_page_da[g_obj_page_da_len-1] != NULL);
+	}
+	int const index = g_obj_entry_number++;
+	obj_hot_arrs_lengthen(g_obj_entry_number);
+	DA_LENGTHEN(g_obj_free_index_da_len += 1, g_obj_free_index_da_cap, g_obj_free_index_da, int);
+	g_obj_free_index_da[g_obj_free_index_da_len-1] = index;
+}
+
+void obj_reserve(obj_reservation_t* reservation, int obj_number)
+{
+	assert(reservation->len == 0);
+	if (obj_number == 0)
+	{
+		return;
+	}
+	while (g_obj_free_index_da_len < obj_number)
+	{
+		obj_add_free_entry();
+	}
+	DA_LENGTHEN(reservation->len = obj_number, reservation->cap, reservation->index_arr, int);
+	g_obj_free_index_da_len -= obj_number;
+	memcpy(reservation->index_arr, &g_obj_free_index_da[g_obj_free_index_da_len],
+		obj_number * sizeof(int));
+}
+
+void obj_unreserve(obj_reservation_t* reservation)
+{
+	if (reservation->len == 0)
+	{
+		return;
+	}
+	int const len = g_obj_free_index_da_len;
+	DA_LENGTHEN(g_obj_free_index_da_len += reservation->len,
+		g_obj_free_index_da_cap, g_obj_free_index_da, int);
+	memcpy(&g_obj_free_index_da[len], reservation->index_arr, reservation->len * sizeof(int));
+	reservation->len = 0;
+}
+
+void obj_set_thread_reservation(obj_reservation_t* reservation)
+{
+	t_obj_reservation = reservation;
+}
+
+unsigned int obj_thread_change_count(void)
+{
+	return t_obj_change_count;
+}
+
 oid_t obj_create(obj_type_t type, loc_t loc, int max_life, material_id_t material_id)
 {
+	pthread_mutex_lock(&g_obj_table_mutex);
+
 	int index;
-	for (int i = 0; i < g_obj_da_len; i++)
+	if (t_obj_reservation != NULL)
 	{
-		if (!g_obj_da[i].used)
+		assert(t_obj_reservation->len > 0
+			/* Creating more objects than reserved would have to extend the table, which
+			 * would move memory that other threads may be reading. */);
+		index = t_obj_reservation->index_arr[--t_obj_reservation->len];
+	}
+	else
+	{
+		/* Reuse an unused entry, or extend the table if there is none. */
+		if (g_obj_free_index_da_len == 0)
 		{
-			index = i;
-			goto index_found;
+			obj_add_free_entry();
 		}
+		index = g_obj_free_index_da[--g_obj_free_index_da_len];
+	}
+
+	obj_entry_t* entry = get_entry(index);
+	assert(!entry->used && !entry->dying);
+	entry->obj = (obj_t){
+		.loc = (loc_t){.type = LOC_NONE}};
+	g_obj_type_arr[index] = type;
+	g_obj_life_arr[index] = max_life;
+	g_obj_max_life_arr[index] = max_life;
+	g_obj_age_arr[index] = 0;
+	g_obj_material_id_arr[index] = material_id;
+	obj_index_list_add(&g_obj_live_list, OBJ_LIST_OF_ALL, index);
+	obj_index_list_add(&g_obj_type_list_table[type], OBJ_LIST_OF_TYPE, index);
+	entry->awake = (g_obj_wakeable_type_set & OBJ_TYPE_SET(type)) != 0;
+	if (entry->awake)
+	{
+		obj_index_list_add(&g_obj_awake_list, OBJ_LIST_OF_AWAKE, index);
 	}
-	assert(g_obj_da_len < INT_MAX);
-	DA_LENGTHEN(g_obj_da_len += 1, g_obj_da_cap, g_obj_da, obj_entry_t);
-	g_obj_da[g_obj_da_len-1] = (obj_entry_t){0};
-	index = g_obj_da_len-1;
-
-	index_found:;
-	obj_entry_t* entry = &g_obj_da[index];
-	obj_t* obj = malloc(sizeof(obj_t));
-	*obj = (obj_t){
-		.type = type,
-		.loc = (loc_t){.type = LOC_NONE},
-		.life = max_life,
-		.max_life = max_life,
-		.material_id = material_id,
-		.age = 0};
-	entry->obj = obj;
 	entry->used = true;
 	entry->generation++;
 	g_obj_count++;
+	g_obj_type_count_table[type]++;
 	oid_t oid = {.index = index, .generation = entry->generation};
+	if (g_obj_recorded_creation_type_set & OBJ_TYPE_SET(type))
+	{
+		DA_LENGTHEN(g_obj_created_oid_da_len += 1, g_obj_created_oid_da_cap,
+			g_obj_created_oid_da, oid_t);
+		g_obj_created_oid_da[g_obj_created_oid_da_len-1] = oid;
+	}
+
+	pthread_mutex_unlock(&g_obj_table_mutex);
 
-	obj_set_loc(oid, loc);
+	if (loc.type != LOC_NONE)
+	{
+		obj_set_loc(oid, loc);
+	}
 	return oid;
 }
 
@@ -269,44 +704,110 @@ static void assert_oid_makes_sens(oid_t oid)
 	{
 		return;
 	}
-	assert(0 <= oid.index && oid.index < g_obj_da_len);
-	obj_entry_t* entry = &g_obj_da[oid.index];
+	assert(0 <= oid.index && oid.index < g_obj_entry_number);
+	obj_entry_t* entry = get_entry(oid.index);
 	assert(oid.generation > 0);
 	assert(entry->generation >= oid.generation
 		/* If the oid of the object to destroy has a bigger generation than the
 		 * entry of its index, then either the index is wrong or we somehow we ended up
 		 * wanting to destroy an object that was not yet created.
-		 * This happens either if there is a bug in the `g_obj_da` handling code or if
+		 * This happens either if there is a bug in the object table handling code or if
 		 * the given oid is corrupted. */);
 	#ifndef DEBUG
 		(void)entry;
 	#endif
 }
 
+/* Releases the entry of an object that is not used anymore,
+ * once nothing refers to its subobjects anymore. */
+static void obj_release_entry(int index)
+{
+	obj_entry_t* entry = get_entry(index);
+	obj_t* obj = &entry->obj;
+	assert(!entry->used);
+	entry->dying = false;
+
+	/* The subobjects are gone by now, and the visual effects are not needed anymore. */
+	oid_da_cleanup(&obj->attached_da);
+	free(obj->visual_effect_da.arr);
+	*obj = (obj_t){0};
+
+	/* The now unused entry is free (or pending if some iterations are ongoing). */
+	if (g_obj_iter_depth > 0)
+	{
+		DA_LENGTHEN(g_obj_pending_free_index_da_len += 1, g_obj_pending_free_index_da_cap,
+			g_obj_pending_free_index_da, int);
+		g_obj_pending_free_index_da[g_obj_pending_free_index_da_len-1] = index;
+	}
+	else
+	{
+		DA_LENGTHEN(g_obj_free_index_da_len += 1, g_obj_free_index_da_cap,
+			g_obj_free_index_da, int);
+		g_obj_free_index_da[g_obj_free_index_da_len-1] = index;
+	}
+}
+
 void obj_destroy(oid_t oid)
 {
 	assert_oid_makes_sens(oid);
 	assert(!oid_eq(oid, OID_NULL));
-	obj_entry_t* entry = &g_obj_da[oid.index];
+	obj_entry_t* entry = get_entry(oid.index);
 	if (entry->used && entry->generation == oid.generation)
 	{
-		obj_t* obj = entry->obj;
+		obj_t* obj = &entry->obj;
+		t_obj_change_count++;
 
-		/* If the object being destroyed contained subobjects,
-		 * then now the subobjects have to be located at the same
-		 * place as the container was. */
-		for (int i = 0; i < obj->attached_da.len; i++)
+		if (g_obj_destruction_is_deferred)
 		{
-			if (oid_eq(obj->attached_da.arr[i], OID_NULL))
+			/* The object is only taken off its tile (so that it stops blocking or being
+			 * hit or blocking vision right away), it keeps its location and subobjects
+			 * for `end_deferred_obj_destruction` to deal with. */
+			if (obj->loc.type == LOC_TILE)
 			{
-				continue;
+				tile_t* tile = get_tile(loc_to_tc(obj->loc));
+				oid_da_remove(&tile->oid_da, oid);
+				tile_account_obj(tile, oid, -1);
+				obj_wake_around(loc_to_tc(obj->loc));
 			}
-			obj_change_loc(obj->attached_da.arr[i], obj->loc);
+		}
+		else
+		{
+			/* If the object being destroyed contained subobjects,
+			 * then now the subobjects have to be located at the same
+			 * place as the container was.
+			 * Each subobject moved away is removed from `attached_da`. */
+			while (obj->attached_da.len > 0)
+			{
+				obj_change_loc(obj->attached_da.arr[obj->attached_da.len-1], obj->loc);
+			}
+			obj_unset_loc(oid);
 		}
 
-		obj_unset_loc(oid);
+		pthread_mutex_lock(&g_obj_table_mutex);
+		obj_index_list_remove(&g_obj_live_list, OBJ_LIST_OF_ALL, oid.index);
+		obj_index_list_remove(&g_obj_type_list_table[g_obj_type_arr[oid.index]],
+			OBJ_LIST_OF_TYPE, oid.index);
+		if (entry->awake)
+		{
+			obj_index_list_remove(&g_obj_awake_list, OBJ_LIST_OF_AWAKE, oid.index);
+			entry->awake = false;
+		}
 		entry->used = false;
 		g_obj_count--;
+		g_obj_type_count_table[g_obj_type_arr[oid.index]]--;
+
+		if (g_obj_destruction_is_deferred)
+		{
+			entry->dying = true;
+			DA_LENGTHEN(g_obj_dying_index_da_len += 1, g_obj_dying_index_da_cap,
+				g_obj_dying_index_da, int);
+			g_obj_dying_index_da[g_obj_dying_index_da_len-1] = oid.index;
+		}
+		else
+		{
+			obj_release_entry(oid.index);
+		}
+		pthread_mutex_unlock(&g_obj_table_mutex);
 	}
 	else
 	{
@@ -317,6 +818,120 @@ void obj_destroy(oid_t oid)
 	}
 }
 
+void begin_deferred_obj_destruction(void)
+{
+	assert(!g_obj_destruction_is_deferred);
+	/* An iteration that was exited without `oid_iter_end` would keep the lists from
+	 * being compacted and the destroyed entries from being reused forever. */
+	assert(g_obj_iter_depth == 0);
+	g_obj_destruction_is_deferred = true;
+}
+
+static int compare_ints(void const* a, void const* b)
+{
+	return (*(int const*)a > *(int const*)b) - (*(int const*)a < *(int const*)b);
+}
+
+void end_deferred_obj_destruction(void)
+{
+	assert(g_obj_destruction_is_deferred);
+	assert(g_obj_iter_depth == 0);
+	g_obj_destruction_is_deferred = false;
+
+	/* Objects may have been destroyed by several threads in any order, but where the
+	 * subobjects end up in their new tile or container must not depend on that. */
+	if (g_obj_dying_index_da_len > 1)
+	{
+		qsort(g_obj_dying_index_da, g_obj_dying_index_da_len, sizeof(int), compare_ints);
+	}
+
+	/* First pass: all the dying objects leave their living containers and all their living
+	 * subobjects are moved out, while every dying object still knows where it was. */
+	for (int i = 0; i < g_obj_dying_index_da_len; i++)
+	{
+		int const index = g_obj_dying_index_da[i];
+		obj_t* obj = &get_entry(index)->obj;
+		if (obj->loc.type == LOC_ATTACHED_TO_OBJ)
+		{
+			obj_t* container = get_obj(obj->loc.attached_to_obj.oid);
+			if (container != NULL)
+			{
+				oid_t const oid = {.index = index, .generation = get_entry(index)->generation};
+				oid_da_remove(&container->attached_da, oid);
+			}
+		}
+		if (obj->attached_da.len > 0)
+		{
+			loc_t const final_loc = dying_obj_final_loc(obj);
+			for (int j = 0; j < obj->attached_da.len; j++)
+			{
+				oid_t const sub_oid = obj->attached_da.arr[j];
+				if (get_entry(sub_oid.index)->dying)
+				{
+					/* It will have its own subobjects moved out when its turn comes. */
+					continue;
+				}
+				/* It is not properly removed from `attached_da` (via `obj_unset_loc`)
+				 * as the whole array is about to be dropped anyway. */
+				get_obj(sub_oid)->loc = (loc_t){.type = LOC_NONE};
+				obj_set_loc(sub_oid, final_loc);
+			}
+			obj->attached_da.len = 0;
+		}
+	}
+
+	/* Second pass: nothing refers to the dying objects anymore. */
+	for (int i = 0; i < g_obj_dying_index_da_len; i++)
+	{
+		obj_release_entry(g_obj_dying_index_da[i]);
+	}
+	g_obj_dying_index_da_len = 0;
+}
+
+static int compare_oids(void const* a, void const* b)
+{
+	oid_t const oid_a = *(oid_t const*)a, oid_b = *(oid_t const*)b;
+	if (oid_a.index != oid_b.index)
+	{
+		return (oid_a.index > oid_b.index) - (oid_a.index < oid_b.index);
+	}
+	return (oid_a.generation > oid_b.generation) - (oid_a.generation < oid_b.generation);
+}
+
+void obj_flush_created(void (*callback)(oid_t oid))
+{
+	/* They may have been created by several threads in any order. */
+	qsort(g_obj_created_oid_da, g_obj_created_oid_da_len, sizeof(oid_t), compare_oids);
+	for (int i = 0; i < g_obj_created_oid_da_len; i++)
+	{
+		if (get_obj(g_obj_created_oid_da[i]) != NULL)
+		{
+			callback(g_obj_created_oid_da[i]);
+		}
+	}
+	g_obj_created_oid_da_len = 0;
+}
+
+/* Like `get_obj`, but also returns dying objects (that are destroyed but whose entry
+ * was not released yet, see `begin_deferred_obj_destruction`). */
+static obj_t* get_obj_even_dying(oid_t oid)
+{
+	assert_oid_makes_sens(oid);
+	if (oid_eq(oid, OID_NULL))
+	{
+		return NULL;
+	}
+	obj_entry_t* entry = get_entry(oid.index);
+	if ((entry->used || entry->dying) && entry->generation == oid.generation)
+	{
+		return &entry->obj;
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
 /* Returns NULL if the oid does not refer to an existing object. */
 obj_t* get_obj(oid_t oid)
 {
@@ -325,10 +940,10 @@ obj_t* get_obj(oid_t oid)
 	{
 		return NULL;
 	}
-	obj_entry_t* entry = &g_obj_da[oid.index];
+	obj_entry_t* entry = get_entry(oid.index);
 	if (entry->used && entry->generation == oid.generation)
 	{
-		return entry->obj;
+		return &entry->obj;
 	}
 	else
 	{
@@ -336,41 +951,177 @@ obj_t* get_obj(oid_t oid)
 	}
 }
 
-void obj_change_loc(oid_t oid, loc_t new_loc)
+obj_type_t obj_type(oid_t oid)
+{
+	assert(get_obj(oid) != NULL);
+	return g_obj_type_arr[oid.index];
+}
+
+int obj_life(oid_t oid)
 {
 	assert(get_obj(oid) != NULL);
-	obj_unset_loc(oid);
+	return g_obj_life_arr[oid.index];
+}
+
+void obj_set_life(oid_t oid, int life)
+{
+	obj_t* obj = get_obj(oid);
+	assert(obj != NULL);
+	if (g_obj_life_arr[oid.index] != life)
+	{
+		g_obj_life_arr[oid.index] = life;
+		t_obj_change_count++;
+		/* Its neighbors may want to react to that (like a crystal healing it). */
+		if (obj->loc.type == LOC_TILE)
+		{
+			obj_wake_around(loc_to_tc(obj->loc));
+		}
+		else
+		{
+			obj_wake(oid);
+			if (obj->loc.type == LOC_ATTACHED_TO_OBJ)
+			{
+				obj_wake(obj->loc.attached_to_obj.oid);
+			}
+		}
+	}
+}
+
+int obj_max_life(oid_t oid)
+{
+	assert(get_obj(oid) != NULL);
+	return g_obj_max_life_arr[oid.index];
+}
+
+int obj_age(oid_t oid)
+{
+	assert(get_obj(oid) != NULL);
+	return g_obj_age_arr[oid.index];
+}
+
+material_id_t obj_material_id(oid_t oid)
+{
+	assert(get_obj(oid) != NULL);
+	return g_obj_material_id_arr[oid.index];
+}
+
+int obj_type_count(obj_type_t type)
+{
+	assert(0 <= type && type < OBJ_TYPE_NUMBER);
+	return g_obj_type_count_table[type];
+}
+
+void age_all_objs(void)
+{
+	/* The unused entries also get older, but it does not matter
+	 * as the age is reset when an entry gets used again.
+	 * Not having to check for that makes the loop trivially vectorizable. */
+	for (int i = 0; i < g_obj_entry_number; i++)
+	{
+		g_obj_age_arr[i]++;
+	}
+}
+
+void destroy_dead_objs(void)
+{
+	for (int i = 0; i < g_obj_entry_number; i++)
+	{
+		if (g_obj_life_arr[i] <= 0)
+		{
+			obj_entry_t* entry = get_entry(i);
+			if (entry->used)
+			{
+				obj_destroy((oid_t){.index = i, .generation = entry->generation});
+			}
+		}
+	}
+}
+
+void obj_change_loc(oid_t oid, loc_t new_loc)
+{
+	obj_t* obj = get_obj(oid);
+	assert(obj != NULL);
+	if (obj->loc.type != LOC_NONE)
+	{
+		obj_unset_loc(oid);
+	}
 	obj_set_loc(oid, new_loc);
 }
 
-bool oid_iter(oid_t* oid)
+/* Iteration step over the given list, see `oid_iter`. */
+static bool obj_index_list_iter(obj_index_list_t* list, obj_list_kind_t kind, oid_t* oid)
 {
 	assert(oid != NULL);
 	assert_oid_makes_sens(*oid);
-	if (!oid_eq(*oid, OID_NULL))
+	int pos;
+	if (oid_eq(*oid, OID_NULL))
 	{
-		oid->index++;
+		g_obj_iter_depth++;
+		pos = 0;
 	}
-	while (oid->index < g_obj_da_len)
+	else
 	{
-		if (g_obj_da[oid->index].used)
+		/* The entry of the previous object still knows its position even if the object
+		 * was destroyed since, as the list is not compacted during iterations. */
+		pos = get_entry(oid->index)->list_pos_table[kind] + 1;
+	}
+	while (pos < list->len)
+	{
+		int const index = list->arr[pos];
+		if (index >= 0)
 		{
-			oid->generation = g_obj_da[oid->index].generation;
+			*oid = (oid_t){.index = index, .generation = get_entry(index)->generation};
 			return true;
 		}
-		oid->index++;
+		pos++;
 	}
+	oid_iter_end(oid);
 	return false;
 }
 
+void oid_iter_end(oid_t* oid)
+{
+	assert(oid != NULL);
+	if (oid_eq(*oid, OID_NULL))
+	{
+		/* Not started or already done. */
+		return;
+	}
+	*oid = OID_NULL;
+	assert(g_obj_iter_depth > 0);
+	g_obj_iter_depth--;
+	if (g_obj_iter_depth == 0)
+	{
+		obj_iterations_done();
+	}
+}
+
+bool oid_iter(oid_t* oid)
+{
+	return obj_index_list_iter(&g_obj_live_list, OBJ_LIST_OF_ALL, oid);
+}
+
+bool oid_iter_type(oid_t* oid, obj_type_t type)
+{
+	assert(0 <= type && type < OBJ_TYPE_NUMBER);
+	return obj_index_list_iter(&g_obj_type_list_table[type], OBJ_LIST_OF_TYPE, oid);
+}
+
+bool oid_iter_awake(oid_t* oid)
+{
+	return obj_index_list_iter(&g_obj_awake_list, OBJ_LIST_OF_AWAKE, oid);
+}
+
 oid_t rand_oid(void)
 {
-	int index = rand() % g_obj_da_len;
-	while (!g_obj_da[index].used)
+	assert(g_obj_live_list.len > 0);
+	int index = g_obj_live_list.arr[rand() % g_obj_live_list.len];
+	while (index < 0)
 	{
-		index = rand() % g_obj_da_len;
+		/* There can only be holes during iterations (and there should not be many). */
+		index = g_obj_live_list.arr[rand() % g_obj_live_list.len];
 	}
-	return (oid_t){.index = index, .generation = g_obj_da[index].generation};
+	return (oid_t){.index = index, .generation = get_entry(index)->generation};
 }
 
 oid_t g_player_oid = {0};
@@ -379,8 +1130,7 @@ oid_t oid_da_find_type(oid_da_t const* da, obj_type_t type)
 {
 	for (int i = 0; i < da->len; i++)
 	{
-		obj_t* obj = get_obj(da->arr[i]);
-		if (obj != NULL && obj->type == type)
+		if (obj_type(da->arr[i]) == type)
 		{
 			return da->arr[i];
 		}
@@ -397,8 +1147,7 @@ bool oid_da_contains_obj_f(oid_da_t const* da, bool (*f)(oid_t oid))
 {
 	for (int i = 0; i < da->len; i++)
 	{
-		oid_t oid = da->arr[i];
-		if (get_obj(oid) != NULL && f(oid))
+		if (f(da->arr[i]))
 		{
 			return true;
 		}
@@ -408,76 +1157,162 @@ bool oid_da_contains_obj_f(oid_da_t const* da, bool (*f)(oid_t oid))
 
 /* Section dedicated to object properties, behaviors and related systems. */
 
+/* Properties that only depend on the type of an object. */
+struct obj_type_traits_t
+{
+	obj_type_t type;
+	char const* name;
+	bool is_blocking;
+	bool can_get_hit_for_now;
+	int vision_blocking;
+	char const* text_representation;
+	int text_representation_stretch;
+	bool is_liquid;
+	bool moves_on_its_own;
+};
+typedef struct obj_type_traits_t obj_type_traits_t;
+
+/* Indexed by `obj_type_t`, in the order of the enum. */
+static obj_type_traits_t const g_obj_type_traits_table[] = {
+	{
+		.type = OBJ_PLAYER, .name = "player",
+		.is_blocking = true, .can_get_hit_for_now = true, .vision_blocking = 1,
+		.text_representation = "@",
+	},
+	{
+		.type = OBJ_CRYSTAL, .name = "crystal",
+		.is_blocking = true, .vision_blocking = 4,
+		.text_representation = "A",
+	},
+	{
+		.type = OBJ_ROCK, .name = "rock",
+		.is_blocking = true, .vision_blocking = 100,
+		.text_representation = "#",
+	},
+	{
+		.type = OBJ_GRASS, .name = "grass",
+		.vision_blocking = 3,
+		.text_representation = " v ",
+	},
+	{
+		.type = OBJ_BUSH, .name = "bush",
+		.is_blocking = true, .can_get_hit_for_now = true, .vision_blocking = 4,
+		.text_representation = "n", .text_representation_stretch = 10,
+	},
+	{
+		.type = OBJ_MOSS, .name = "moss",
+		.vision_blocking = 1,
+		.text_representation = " .. ",
+	},
+	{
+		.type = OBJ_TREE, .name = "tree",
+		.is_blocking = true, .vision_blocking = 8,
+		.text_representation = "Y",
+	},
+	{
+		.type = OBJ_SEED, .name = "seed",
+		.vision_blocking = 0,
+		.text_representation = "  .  ",
+	},
+	{
+		.type = OBJ_SLIME, .name = "slime",
+		.is_blocking = true, .can_get_hit_for_now = true, .vision_blocking = 2,
+		.text_representation = "o",
+		.moves_on_its_own = true,
+	},
+	{
+		.type = OBJ_CATERPILLAR, .name = "caterpillar",
+		.is_blocking = true, .can_get_hit_for_now = true, .vision_blocking = 1,
+		.text_representation = "~",
+		.moves_on_its_own = true,
+	},
+	{
+		.type = OBJ_EGG, .name = "egg",
+		.is_blocking = true, .can_get_hit_for_now = true, .vision_blocking = 2,
+		.text_representation = " o ",
+	},
+	{
+		.type = OBJ_LIQUID, .name = "liquid",
+		.vision_blocking = 1,
+		.text_representation = "~",
+		.is_liquid = true,
+	},
+};
+_Static_assert(
+	sizeof g_obj_type_traits_table / sizeof g_obj_type_traits_table[0] == OBJ_TYPE_NUMBER,
+	"Some object types have not been added to the object type traits table.");
+
+static obj_type_traits_t const* obj_type_traits(obj_type_t type)
+{
+	assert(0 <= type && type < OBJ_TYPE_NUMBER);
+	assert(g_obj_type_traits_table[type].type == type
+		/* The table must be in the order of the `obj_type_t` enum. */);
+	return &g_obj_type_traits_table[type];
+}
+
+char const* obj_type_name(obj_type_t type)
+{
+	return obj_type_traits(type)->name;
+}
+
+bool obj_type_is_blocking(obj_type_t type)
+{
+	return obj_type_traits(type)->is_blocking;
+}
+
+bool obj_type_can_get_hit_for_now(obj_type_t type)
+{
+	return obj_type_traits(type)->can_get_hit_for_now;
+}
+
+int obj_type_vision_blocking(obj_type_t type)
+{
+	return obj_type_traits(type)->vision_blocking;
+}
+
+char const* obj_type_text_representation(obj_type_t type)
+{
+	return obj_type_traits(type)->text_representation;
+}
+
+int obj_type_text_representation_stretch(obj_type_t type)
+{
+	return obj_type_traits(type)->text_representation_stretch;
+}
+
+bool obj_type_is_liquid(obj_type_t type)
+{
+	return obj_type_traits(type)->is_liquid;
+}
+
+bool obj_type_moves_on_its_own(obj_type_t type)
+{
+	return obj_type_traits(type)->moves_on_its_own;
+}
+
 char const* obj_name(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	return obj_type_name(obj->type);
+	return obj_type_name(obj_type(oid));
 }
 
 bool obj_is_blocking(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_TREE:
-		case OBJ_ROCK:
-		case OBJ_CRYSTAL:
-		case OBJ_BUSH:
-		case OBJ_SLIME:
-		case OBJ_CATERPILLAR:
-		case OBJ_EGG:
-		case OBJ_PLAYER:
-			return true;
-		default:
-			return false;
-	}
+	return obj_type_is_blocking(obj_type(oid));
 }
 
 bool obj_can_get_hit_for_now(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_BUSH:
-		case OBJ_SLIME:
-		case OBJ_CATERPILLAR:
-		case OBJ_EGG:
-		case OBJ_PLAYER:
-			return true;
-		default:
-			return false;
-	}
+	return obj_type_can_get_hit_for_now(obj_type(oid));
 }
 
 int obj_vision_blocking(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_GRASS:       return 3;
-		case OBJ_BUSH:        return 4;
-		case OBJ_MOSS:        return 1;
-		case OBJ_TREE:        return 8;
-		case OBJ_SEED:        return 0;
-		case OBJ_ROCK:        return 100;
-		case OBJ_CRYSTAL:     return 4;
-		case OBJ_SLIME:       return 2;
-		case OBJ_CATERPILLAR: return 1;
-		case OBJ_EGG:         return 2;
-		case OBJ_LIQUID:      return 1;
-		default:              return 1;
-	}
+	return obj_type_vision_blocking(obj_type(oid));
 }
 
 rgb_t obj_foreground_color(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	material_t* material = get_material(obj->material_id);
+	material_t* material = get_material(obj_material_id(oid));
 	return material->primary_color;
 	#if 0
 	switch (obj->type)
@@ -521,72 +1356,32 @@ rgb_t obj_foreground_color(oid_t oid)
 
 char const* obj_text_representation(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_PLAYER:      return "@";
-		case OBJ_CRYSTAL:     return "A";
-		case OBJ_ROCK:        return "#";
-		case OBJ_TREE:        return "Y";
-		case OBJ_SEED:        return "  .  ";
-		case OBJ_BUSH:        return "n";
-		case OBJ_SLIME:       return "o";
-		case OBJ_CATERPILLAR: return "~";
-		case OBJ_EGG:         return " o ";
-		case OBJ_GRASS:       return " v ";
-		case OBJ_MOSS:        return " .. ";
-		case OBJ_LIQUID:      return "~";
-		default:              return "X";
-	}
+	return obj_type_text_representation(obj_type(oid));
 }
 
 int obj_text_representation_stretch(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_BUSH: return 10;
-		default:       return 0;
-	}
+	return obj_type_text_representation_stretch(obj_type(oid));
 }
 
 rgb_t obj_background_color(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	material_t* material = get_material(obj->material_id);
-	switch (obj->type)
+	if (obj_is_liquid(oid))
 	{
-		case OBJ_LIQUID: return material->secondary_color;
-		default:         return g_color_bg;
+		return get_material(obj_material_id(oid))->secondary_color;
+	}
+	else
+	{
+		return g_color_bg;
 	}
 }
 
 bool obj_is_liquid(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_LIQUID:
-			return true;
-		default:
-			return false;
-	}
+	return obj_type_is_liquid(obj_type(oid));
 }
 
 bool obj_moves_on_its_own(oid_t oid)
 {
-	obj_t* obj = get_obj(oid);
-	assert(obj != NULL);
-	switch (obj->type)
-	{
-		case OBJ_SLIME:
-		case OBJ_CATERPILLAR:
-			return true;
-		default:
-			return false;
-	}
+	return obj_type_moves_on_its_own(obj_type(oid));
 }
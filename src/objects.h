@@ -10,7 +10,7 @@
 /* Section `oid_t`. */
 
 /* An object ID in the global table of all objects.
- * An `oid_t` refers to an object of the `g_obj_da` global dynamic array of objects.
+ * An `oid_t` refers to an object of the global table of all objects (see `objects.c`).
  * References to objects should be `oid_t`s instead of pointers. That is because
  * when an object is destroyed, its `oid_t` is still safe to use (it just does not
  * point to an object anymore) unlike a pointer.
@@ -18,7 +18,7 @@
  * outside of `objects.c`. */
 struct oid_t
 {
-	/* Index in `g_obj_da`. */
+	/* Index in the global table of objects. */
 	int index;
 	/* Generation that must match the generation of the `index`-th entry.
 	 * If it does not match then it means the object referenced by this id
@@ -27,7 +27,7 @@ struct oid_t
 };
 typedef struct oid_t oid_t;
 
-/* `0` cannot be the generation of any used entry in `g_obj_da` (minimum is 1),
+/* `0` cannot be the generation of any used entry in the table (minimum is 1),
  * so `(oid_t){0}` can be used to represent a null id or something. */
 #define OID_NULL (oid_t){0}
 
@@ -134,17 +134,29 @@ void visual_effect_obj_da_remove(visual_effect_obj_da_t* da, int index);
 
 /* Section `oid_da_t`. */
 
+/* Number of `oid_t`s that an `oid_da_t` can hold without allocating memory.
+ * Most tiles and objects only hold a few objects. */
+#define OID_DA_INLINE_CAP 3
+
+/* Dynamic array of `oid_t`s with some inline storage (it only allocates memory
+ * when it holds more than `OID_DA_INLINE_CAP` elements).
+ * It starts zero-initialized, and must not be copied (as `arr` may point to the inline
+ * storage of the original) unless it is empty. */
 struct oid_da_t
 {
-	/* May contain null `oid_t`s.
-	 * Should not be treated as if it is in a particular order. */
+	/* Does not contain null `oid_t`s (removed elements are not left as holes).
+	 * Should not be treated as if it is in a particular order.
+	 * Points to either `inline_arr` or heap-allocated memory (or is NULL if nothing
+	 * was ever added). */
 	oid_t* arr;
 	int len, cap;
+	oid_t inline_arr[OID_DA_INLINE_CAP];
 };
 typedef struct oid_da_t oid_da_t;
 
 void oid_da_add(oid_da_t* da, oid_t oid);
 void oid_da_remove(oid_da_t* da, oid_t oid);
+void oid_da_cleanup(oid_da_t* da);
 
 /* Section `obj_t`. */
 
@@ -173,18 +185,22 @@ typedef enum obj_type_t obj_type_t;
 
 char const* obj_type_name(obj_type_t type);
 
+/* A set of object types, as a bit field indexed by `obj_type_t`. */
+typedef unsigned int obj_type_set_t;
+#define OBJ_TYPE_SET(type_) ((obj_type_set_t)1 << (type_))
+_Static_assert(OBJ_TYPE_NUMBER <= sizeof(obj_type_set_t) * 8,
+	"Object type sets must have a bit for every object type");
+
 /* An object of the game.
  * Pretty much everything that physically exists
- * in the world is or should be an object. */
+ * in the world is or should be an object.
+ * The fields that are accessed by loops over all the objects (type, life, max life,
+ * age and material) are not in there, they are stored in parallel arrays instead
+ * (see `objects.c`) and accessed via `obj_type` and the like. */
 struct obj_t
 {
-	obj_type_t type;
 	loc_t loc;
 	oid_da_t attached_da;
-	int life;
-	int max_life;
-	material_id_t material_id;
-	int age;
 
 	visual_effect_obj_da_t visual_effect_da;
 };
@@ -192,19 +208,112 @@ typedef struct obj_t obj_t;
 
 extern int g_obj_count;
 
+/* An object can be created nowhere (with the `LOC_NONE` location), in which case it is
+ * not in the world until it is given a location via `obj_change_loc` (or destroyed). */
 oid_t obj_create(obj_type_t type, loc_t loc, int max_life, material_id_t material_id);
 void obj_destroy(oid_t oid);
 obj_t* get_obj(oid_t oid);
 
+/* Between these two calls, destroying an object only takes it off its tile and marks
+ * it as dying (`get_obj` returns NULL for it right away, and iterations skip it).
+ * Its subobjects remain where they are until `end_deferred_obj_destruction`, which
+ * moves the subobjects of all the dying objects out and releases their entries
+ * in one sweep. It must not be called during an iteration over objects. */
+void begin_deferred_obj_destruction(void);
+void end_deferred_obj_destruction(void);
+
+/* The objects of these types are recorded when created, until they are handed over
+ * by `obj_flush_created` (in the order of their indices, skipping the ones that were
+ * destroyed in the meantime). */
+extern obj_type_set_t g_obj_recorded_creation_type_set;
+void obj_flush_created(void (*callback)(oid_t oid));
+
+/* Objects of these types are awake when created. The other objects are always asleep,
+ * as nothing is to be done to them by the laws that are applied every turn. */
+extern obj_type_set_t g_obj_wakeable_type_set;
+/* An object that has nothing to do can be put to sleep, so that the laws applied every
+ * turn leave it alone. It is woken when something changes on its tile or on the tiles
+ * next to it (an object coming or leaving, or getting damaged or healed), when its life
+ * changes or when something is attached to it or detached from it. */
+void obj_wake(oid_t oid);
+void obj_sleep(oid_t oid);
+
+/* Objects can be created and destroyed by several threads at once, as long as each
+ * thread only touches objects (and tiles) that no other thread touches in the meantime.
+ * The entries that new objects get must then be reserved beforehand (by only one thread)
+ * for each of the creating threads, so that the table does not have to grow while being
+ * read, and so that which object gets which entry does not depend on how the threads
+ * interleave. */
+struct obj_reservation_t
+{
+	/* Indices of the reserved entries, used as a stack. It starts zero-initialized and
+	 * can be reused for several reservations. */
+	int* index_arr;
+	int len, cap;
+};
+typedef struct obj_reservation_t obj_reservation_t;
+
+/* Reserves entries for `obj_number` objects. */
+void obj_reserve(obj_reservation_t* reservation, int obj_number);
+/* Gives the entries that were not used back. */
+void obj_unreserve(obj_reservation_t* reservation);
+/* Makes the objects created by the calling thread take their entries from the given
+ * reservation (or from the table as usual if NULL). */
+void obj_set_thread_reservation(obj_reservation_t* reservation);
+
+/* Number of changes made to the objects by the calling thread so far (objects created,
+ * destroyed, moved or getting their life changed), so that one can tell whether some
+ * code did something by comparing it before and after. */
+unsigned int obj_thread_change_count(void);
+
+obj_type_t obj_type(oid_t oid);
+int obj_life(oid_t oid);
+void obj_set_life(oid_t oid, int life);
+int obj_max_life(oid_t oid);
+int obj_age(oid_t oid);
+material_id_t obj_material_id(oid_t oid);
+
+/* Number of objects of the given type. */
+int obj_type_count(obj_type_t type);
+
+/* Increments the age of all the objects. */
+void age_all_objs(void);
+/* Destroys all the objects that have no life left. */
+void destroy_dead_objs(void);
+
 void obj_change_loc(oid_t oid, loc_t new_loc);
 
 /* Iterate over all the objects there is, like so:
  *    oid_t oid = OID_NULL;
  *    while (oid_iter(&oid)) {...}
  * At every step the oid will be refering to an existing object.
- * Note that it is even possible to destroy the referred object. */
+ * Note that it is even possible to destroy the referred object (or any other object).
+ * Objects created during the iteration are also iterated over.
+ * Some bookkeeping is deferred until all the iterations are done, so a loop exited
+ * before `oid_iter` returns false (which also sets the oid back to `OID_NULL`)
+ * must call `oid_iter_end` (this is checked at the beginning of each turn). */
 bool oid_iter(oid_t* oid);
 
+/* Ends the iteration (of any kind) that is at the given oid, like so:
+ *    oid_t oid = OID_NULL;
+ *    while (oid_iter(&oid)) {if (...) {break;}}
+ *    oid_iter_end(&oid);
+ * It does nothing if the iteration is already done (or did not start). */
+void oid_iter_end(oid_t* oid);
+
+/* Iterate over all the objects of the given type, like so:
+ *    oid_t oid = OID_NULL;
+ *    while (oid_iter_type(&oid, type)) {...}
+ * It has the same guarantees and constraints as `oid_iter`. */
+bool oid_iter_type(oid_t* oid, obj_type_t type);
+
+/* Iterate over all the awake objects (see `obj_wake`), like so:
+ *    oid_t oid = OID_NULL;
+ *    while (oid_iter_awake(&oid)) {...}
+ * It has the same guarantees and constraints as `oid_iter`. An object put to sleep
+ * and woken up again during the iteration keeps its place in it. */
+bool oid_iter_awake(oid_t* oid);
+
 oid_t rand_oid(void);
 
 extern oid_t g_player_oid;
@@ -215,6 +324,16 @@ bool oid_da_contains_obj_f(oid_da_t const* da, bool (*f)(oid_t oid));
 
 /* Section dedicated to object properties, behaviors and related systems. */
 
+/* Properties that only depend on the type of an object (looked up in a table),
+ * to be used when the type is already known to skip looking up the object. */
+bool obj_type_is_blocking(obj_type_t type);
+bool obj_type_can_get_hit_for_now(obj_type_t type);
+int obj_type_vision_blocking(obj_type_t type);
+char const* obj_type_text_representation(obj_type_t type);
+int obj_type_text_representation_stretch(obj_type_t type);
+bool obj_type_is_liquid(obj_type_t type);
+bool obj_type_moves_on_its_own(obj_type_t type);
+
 char const* obj_name(oid_t oid);
 bool obj_is_blocking(oid_t oid);
 bool obj_can_get_hit_for_now(oid_t oid);
@@ -0,0 +1,61 @@
+
+#include "rng.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+uint64_t g_world_seed = 0;
+
+/* The stream of the current thread, if any. */
+static _Thread_local bool t_rng_has_stream = false;
+static _Thread_local uint64_t t_rng_key;
+static _Thread_local uint64_t t_rng_counter;
+
+#define RNG_GOLDEN_GAMMA 0x9e3779b97f4a7c15
+
+/* The finalizer of SplitMix64, a good enough hash for 64-bit values. */
+static uint64_t rng_mix(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+uint64_t rng_key(uint64_t key, uint64_t value)
+{
+	return rng_mix(key ^ rng_mix(value + RNG_GOLDEN_GAMMA));
+}
+
+uint64_t rng_domain_key(rng_domain_t domain)
+{
+	return rng_key(g_world_seed, domain);
+}
+
+void rng_begin_stream(uint64_t key)
+{
+	assert(!t_rng_has_stream);
+	t_rng_has_stream = true;
+	t_rng_key = key;
+	t_rng_counter = 0;
+}
+
+void rng_end_stream(void)
+{
+	assert(t_rng_has_stream);
+	t_rng_has_stream = false;
+}
+
+int rng_rand(void)
+{
+	if (t_rng_has_stream)
+	{
+		/* This is SplitMix64 (whose state is just a counter), and the 31 high bits
+		 * fit in a non-negative `int`. */
+		t_rng_counter++;
+		return (int)(rng_mix(t_rng_key + t_rng_counter * RNG_GOLDEN_GAMMA) >> 33);
+	}
+	else
+	{
+		return rand();
+	}
+}
@@ -0,0 +1,44 @@
+
+#ifndef WHYCRYSTALS_HEADER_RNG_
+#define WHYCRYSTALS_HEADER_RNG_
+
+#include <stdint.h>
+
+/* Random numbers for the world are not drawn from one global sequence (which would
+ * make them depend on the order in which everything is done), they are drawn from
+ * streams that are keyed by what they are for (like the world seed, the turn number
+ * and the object for the laws). A stream is a counter that goes through a hash, so
+ * starting one is free and the numbers only ever depend on its key, which makes
+ * the world the same for a given seed however (and by however many threads)
+ * it is simulated.
+ * Each thread has its own current stream (begun via `rng_begin_stream`), and without one
+ * the numbers come from `rand` (which is fine for what is not part of the world). */
+
+/* Everything random in the world derives from it. */
+extern uint64_t g_world_seed;
+
+/* What streams are for, so that streams for different things never coincide. */
+enum rng_domain_t
+{
+	RNG_DOMAIN_LAW,
+	RNG_DOMAIN_MATERIAL,
+	RNG_DOMAIN_MAP_PATH,
+	RNG_DOMAIN_BIOME,
+	RNG_DOMAIN_MAP_TILE,
+	RNG_DOMAIN_PLAYER_SPAWN,
+	RNG_DOMAIN_LAW_LOD,
+};
+typedef enum rng_domain_t rng_domain_t;
+
+/* Derives a key from a key and a value, close values giving unrelated keys. */
+uint64_t rng_key(uint64_t key, uint64_t value);
+/* The key of the given domain in the current world, to derive stream keys from. */
+uint64_t rng_domain_key(rng_domain_t domain);
+
+void rng_begin_stream(uint64_t key);
+void rng_end_stream(void);
+
+/* Returns a non-negative number, to be used like the result of `rand`. */
+int rng_rand(void);
+
+#endif /* WHYCRYSTALS_HEADER_RNG_ */
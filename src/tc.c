@@ -1,5 +1,6 @@
 
 #include "tc.h"
+#include "rng.h"
 #include <stdlib.h>
 #include <assert.h>
 
@@ -17,7 +18,7 @@ bool tc_in_rect(tc_t tc, tc_rect_t rect)
 
 tm_t rand_tm_one(void)
 {
-	return TM_ONE_ALL[rand() % 4];
+	return TM_ONE_ALL[rng_rand() % 4];
 }
 
 bool tm_one_orthogonal(tm_t a, tm_t b)
@@ -0,0 +1,946 @@
+
+#include "vision.h"
+#include "mapgrid.h"
+#include "utils.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/* The tiles around the source are split in 8 octants by which axis the rays to them
+ * mostly go along and in which directions. The rays to the tiles strictly inside of
+ * an octant stay in that octant, only getting on its edges (the half-lines going from
+ * the source along the axis or the diagonal), so the insides of the octants can be
+ * computed independently and only the edges, shared by two octants, are to be merged.
+ * In the coordinates of an octant, `k` goes along the major axis (away from the source)
+ * and `m` goes along the minor axis, the inside being `0 < m < k`. */
+
+/* An edge of an octant, as seen by the rays to the tiles inside of the octant. */
+struct vision_edge_t
+{
+	/* Indexed by the distance to the source, the best vision of the rays that got there. */
+	int* vision_arr;
+	/* The tile index (in the map grid) of the target of the first ray that got there
+	 * (`INT_MAX` if none did), the rays being cast in the order of their targets. */
+	int* first_target_index_arr;
+	/* Beyond this distance no ray got there. */
+	int len;
+};
+typedef struct vision_edge_t vision_edge_t;
+
+struct vision_octant_t
+{
+	bool x_major;
+	int major_sign, minor_sign;
+	/* Along the major axis (`m == 0`) and along the diagonal (`m == k`). */
+	vision_edge_t edge_table[2];
+	/* Bounds of the tiles inside of the octant that have a non-zero vision
+	 * (empty if `x_min > x_max`). */
+	int x_min, x_max, y_min, y_max;
+	/* Some of the tiles it sees changed since it was computed. */
+	bool is_dirty;
+	/* How far the map grid goes from the source along the major and minor axes,
+	 * set when the octant is computed. */
+	int k_lim, m_lim;
+};
+typedef struct vision_octant_t vision_octant_t;
+
+static vision_octant_t g_vision_octant_table[8];
+
+/* The 8 half-lines going from the source along the axes and the diagonals, that are
+ * the edges of the octants. Each half-line is also cast as a ray (in the order of its
+ * tiles, as it only sees its own tiles), which is merged with the edges. */
+struct vision_half_line_t
+{
+	tm_t dir;
+	/* The two octants that have the half-line as an edge, and these edges. */
+	int octant_index_table[2];
+	vision_edge_t* edge_table[2];
+	/* Beyond this distance the tiles of the half-line have a vision of zero. */
+	int len;
+};
+typedef struct vision_half_line_t vision_half_line_t;
+
+static vision_half_line_t g_vision_half_line_table[8];
+
+/* What the current vision was computed for. */
+static tc_t g_vision_src_tc;
+/* The `g_mg_generation` of the map grid it was computed in. */
+static unsigned int g_vision_mg_generation = 0;
+
+/* The tiles that may have a non-zero vision, all the other tiles having a vision
+ * of zero. Vision only reaches a few tiles around its source (every tile but the
+ * empty ones takes some of it away), so only these have to be looked at. */
+static tc_rect_t g_vision_rect = {0, 0, 0, 0};
+
+/* Scratch buffer of the vision of a half-line cast as a ray. */
+static int* g_vision_half_line_arr = NULL;
+
+/* In the coordinates of an octant (that are the same for every octant), the rays to the
+ * tiles inside of it all go from the source and share the beginning of their paths.
+ * These paths make a tree whose root is the source, so that what the rays see along the way
+ * is computed once per node for all the rays that go through it (instead of once per ray).
+ * Only the nodes that still see something get children, so the tree only covers what can be
+ * seen, however big the map grid is (see `vision_octant_compute`).
+ * The ray to the tile `(K, M)` gets to `(j, m_j)` with `m_j = (2jM + K - 1) / (2K)` (rounded
+ * down, which gives the same steps as `line_bresenham_iter`), so the rays that go through
+ * a node are the rays to the tiles `(K, M)` such that `(2c - 1)K + 1 <= 2jM <= (2c + 1)K`
+ * for every node `(j, c)` on the way from the root to it (but the root). These tiles are
+ * in a cone that only gets wider with `K`, and there are some (far enough) if and only if
+ * the slope `M / K` can be both above every `(2c - 1) / 2j` and at most every `(2c + 1) / 2j`. */
+struct vision_ray_node_t
+{
+	int k, m;
+	int parent; /* -1 for the root. */
+	int child_table[2]; /* The next node with the same `m` or with `m + 1` (-1 if none). */
+	/* The greatest `(2c - 1) / 2j` and the smallest `(2c + 1) / 2j` of the way to it. */
+	int slope_lo_num, slope_lo_den, slope_hi_num, slope_hi_den;
+	/* What remains of the vision of the rays when they get to the node, with which
+	 * they see its tile (zero if they stopped before, then the node has no children). */
+	int vision;
+	/* The index in the map grid of the first tile (in the order of the map grid) whose ray
+	 * goes through the node among the tiles that no ray can see (`INT_MAX` if none).
+	 * The rays to these tiles are always cast (as they are never seen), so the node is
+	 * seen when this one is cast if not by an earlier ray. */
+	int first_unseeable_target_index;
+	/* A ray that was cast went through the node, its tile being seen accordingly. */
+	bool is_seen;
+};
+typedef struct vision_ray_node_t vision_ray_node_t;
+
+static vision_ray_node_t* g_vision_ray_node_da = NULL;
+static int g_vision_ray_node_da_len = 0, g_vision_ray_node_da_cap = 0;
+
+/* For each tile inside of an octant (see `vision_ray_target_index`), whether a node of the tree
+ * sees it, that is whether some ray can see it. Only these tiles are cast rays to one by one,
+ * (they are the events of `g_vision_ray_event_da` without a node), as the rays to the others are cast
+ * whatever happens and are accounted for by the nodes they go through. */
+static bool* g_vision_ray_is_seeable_arr = NULL;
+static int g_vision_ray_is_seeable_arr_len = 0;
+
+static int vision_ray_target_index(int k, int m)
+{
+	assert(0 < m && m < k);
+	return (k - 1) * (k - 2) / 2 + (m - 1);
+}
+
+/* What happens when the ray to the tile of index `target_index` in the map grid is cast,
+ * in the order of the map grid: either that tile is seeable (`node` being -1) and its ray is
+ * cast if it is not seen yet, or it is not and its ray sees `node` (if not seen yet). */
+struct vision_ray_event_t
+{
+	int target_index;
+	int node;
+	int k, m;
+};
+typedef struct vision_ray_event_t vision_ray_event_t;
+
+static vision_ray_event_t* g_vision_ray_event_da = NULL;
+static int g_vision_ray_event_da_len = 0, g_vision_ray_event_da_cap = 0;
+
+/* Where the given octant coordinates are relatively to the source. */
+static tm_t vision_octant_tm(vision_octant_t const* octant, int k, int m)
+{
+	int const major = octant->major_sign * k, minor = octant->minor_sign * m;
+	return octant->x_major ? (tm_t){major, minor} : (tm_t){minor, major};
+}
+
+static void vision_edge_clear(vision_edge_t* edge)
+{
+	for (int i = 0; i < edge->len; i++)
+	{
+		edge->vision_arr[i] = 0;
+		edge->first_target_index_arr[i] = INT_MAX;
+	}
+	edge->len = 0;
+}
+
+/* Sets up the octants and half-lines for a map grid of the size of the current one. */
+static void vision_init(void)
+{
+	int const len = max(g_mg_rect.w, g_mg_rect.h) + 1;
+	int octant_index = 0;
+	for (int x_major = 1; x_major >= 0; x_major--)
+	for (int major_sign = -1; major_sign <= 1; major_sign += 2)
+	for (int minor_sign = -1; minor_sign <= 1; minor_sign += 2)
+	{
+		vision_octant_t* octant = &g_vision_octant_table[octant_index++];
+		octant->x_major = x_major;
+		octant->major_sign = major_sign;
+		octant->minor_sign = minor_sign;
+		for (int i = 0; i < 2; i++)
+		{
+			vision_edge_t* edge = &octant->edge_table[i];
+			edge->vision_arr = realloc(edge->vision_arr, len * sizeof(int));
+			edge->first_target_index_arr =
+				realloc(edge->first_target_index_arr, len * sizeof(int));
+			assert(edge->vision_arr != NULL && edge->first_target_index_arr != NULL);
+			edge->len = len;
+			vision_edge_clear(edge);
+		}
+		octant->x_min = INT_MAX, octant->x_max = INT_MIN;
+		octant->y_min = INT_MAX, octant->y_max = INT_MIN;
+		octant->is_dirty = true;
+	}
+
+	int half_line_index = 0;
+	for (int dy = -1; dy <= 1; dy++)
+	for (int dx = -1; dx <= 1; dx++)
+	{
+		if (dx == 0 && dy == 0)
+		{
+			continue;
+		}
+		vision_half_line_t* half_line = &g_vision_half_line_table[half_line_index++];
+		half_line->dir = (tm_t){dx, dy};
+		half_line->len = 0;
+		int edge_number = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			vision_octant_t* octant = &g_vision_octant_table[i];
+			for (int j = 0; j < 2; j++)
+			{
+				/* Where the edge goes from the source (`m` being `0` or `k`). */
+				if (tc_eq(vision_octant_tm(octant, 1, j), half_line->dir))
+				{
+					half_line->octant_index_table[edge_number] = i;
+					half_line->edge_table[edge_number] = &octant->edge_table[j];
+					edge_number++;
+				}
+			}
+		}
+		assert(edge_number == 2);
+	}
+
+	g_vision_half_line_arr = realloc(g_vision_half_line_arr, len * sizeof(int));
+	assert(g_vision_half_line_arr != NULL);
+
+}
+
+/* Returns the octant that the given tile is strictly inside of, or -1 if the tile
+ * is on a half-line. */
+static int vision_octant_index_of(tc_t tc)
+{
+	int const dx = tc.x - g_vision_src_tc.x, dy = tc.y - g_vision_src_tc.y;
+	if (dx == 0 || dy == 0 || abs(dx) == abs(dy))
+	{
+		return -1;
+	}
+	bool const x_major = abs(dx) > abs(dy);
+	int const major_sign = (x_major ? dx : dy) > 0 ? 1 : -1;
+	int const minor_sign = (x_major ? dy : dx) > 0 ? 1 : -1;
+	return (x_major ? 0 : 4) + (major_sign > 0 ? 2 : 0) + (minor_sign > 0 ? 1 : 0);
+}
+
+/* Returns the half-line that the given tile (that is not the source) is on,
+ * or -1 if the tile is strictly inside of an octant. */
+static int vision_half_line_index_of(tc_t tc)
+{
+	int const dx = tc.x - g_vision_src_tc.x, dy = tc.y - g_vision_src_tc.y;
+	if (dx != 0 && dy != 0 && abs(dx) != abs(dy))
+	{
+		return -1;
+	}
+	int const index = (dy > 0 ? 2 : dy < 0 ? 0 : 1) * 3 + (dx > 0 ? 2 : dx < 0 ? 0 : 1);
+	return index < 4 ? index : index - 1;
+}
+
+/* The index in the map grid of the tile at the given octant coordinates. */
+static int vision_octant_mg_index(vision_octant_t const* octant, int k, int m)
+{
+	tc_t const tc = tc_add_tm(g_vision_src_tc, vision_octant_tm(octant, k, m));
+	return tile_index(tc);
+}
+
+/* Gets the part `[*x_begin, *x_end)` of the row `y` of the map grid that is inside
+ * of the octant, returning false if there is none. */
+static bool vision_octant_row_span(vision_octant_t const* octant, int y,
+	int* x_begin, int* x_end)
+{
+	int const src_x = g_vision_src_tc.x;
+	int const dy = y - g_vision_src_tc.y;
+	int const row_sign = dy > 0 ? 1 : -1;
+	if (dy == 0 || row_sign != (octant->x_major ? octant->minor_sign : octant->major_sign))
+	{
+		return false;
+	}
+	int const column_sign = octant->x_major ? octant->major_sign : octant->minor_sign;
+	if (octant->x_major)
+	{
+		*x_begin = column_sign > 0 ? src_x + abs(dy) + 1 : 0;
+		*x_end = column_sign > 0 ? g_mg_rect.w : src_x - abs(dy);
+	}
+	else
+	{
+		*x_begin = column_sign > 0 ? src_x + 1 : src_x - abs(dy) + 1;
+		*x_end = column_sign > 0 ? src_x + abs(dy) : src_x;
+	}
+	*x_begin = max(*x_begin, 0);
+	*x_end = min(*x_end, g_mg_rect.w);
+	return *x_begin < *x_end;
+}
+
+/* The tile at the given octant coordinates is seen by the ray to the given target
+ * with the given vision, which is recorded in the edges if it is on one.
+ * Returns the index of the tile in the map grid. */
+static int vision_octant_see(vision_octant_t* octant, int target_index,
+	int k, int m, int vision)
+{
+	int const tile_index = vision_octant_mg_index(octant, k, m);
+	if (m == 0 || m == k)
+	{
+		vision_edge_t* edge = &octant->edge_table[m == 0 ? 0 : 1];
+		if (edge->vision_arr[k] == 0)
+		{
+			edge->first_target_index_arr[k] = target_index;
+		}
+		edge->vision_arr[k] = max(edge->vision_arr[k], vision);
+		edge->len = max(edge->len, k + 1);
+	}
+	else if (g_mg_vision_arr[tile_index] < vision)
+	{
+		g_mg_vision_arr[tile_index] = vision;
+		tc_t const tc = tc_add_tm(g_vision_src_tc, vision_octant_tm(octant, k, m));
+		octant->x_min = min(octant->x_min, tc.x);
+		octant->x_max = max(octant->x_max, tc.x);
+		octant->y_min = min(octant->y_min, tc.y);
+		octant->y_max = max(octant->y_max, tc.y);
+	}
+	return tile_index;
+}
+
+/* Gets the range `[*m_lo, *m_hi]` of the `M` such that the ray to the tile `(K, M)` inside
+ * of the octant goes through the given node (empty if `*m_lo > *m_hi`). */
+static void vision_ray_node_m_span(int node, int big_k, int* m_lo, int* m_hi)
+{
+	*m_lo = 1;
+	*m_hi = big_k - 1;
+	for (; node > 0; node = g_vision_ray_node_da[node].parent)
+	{
+		int const j = g_vision_ray_node_da[node].k, c = g_vision_ray_node_da[node].m;
+		if (c > 0)
+		{
+			*m_lo = max(*m_lo, ((2 * c - 1) * big_k + 2 * j) / (2 * j));
+		}
+		*m_hi = min(*m_hi, (2 * c + 1) * big_k / (2 * j));
+	}
+}
+
+/* Gets the range `[*k_lo, *k_hi]` of the `K` such that the ray to the tile `(K, M)` inside
+ * of the octant goes through the given node (empty if `*k_lo > *k_hi`). */
+static void vision_ray_node_k_span(int node, int big_m, int* k_lo, int* k_hi)
+{
+	*k_lo = max(big_m + 1, g_vision_ray_node_da[node].k);
+	*k_hi = INT_MAX;
+	for (; node > 0; node = g_vision_ray_node_da[node].parent)
+	{
+		int const j = g_vision_ray_node_da[node].k, c = g_vision_ray_node_da[node].m;
+		if (c > 0)
+		{
+			*k_hi = min(*k_hi, (2 * j * big_m - 1) / (2 * c - 1));
+		}
+		*k_lo = max(*k_lo, (2 * j * big_m + 2 * c) / (2 * c + 1));
+	}
+}
+
+static bool vision_ray_target_is_seeable(int k, int m)
+{
+	int const index = vision_ray_target_index(k, m);
+	return index < g_vision_ray_is_seeable_arr_len && g_vision_ray_is_seeable_arr[index];
+}
+
+/* Returns the index in the map grid of the first tile inside of the octant (in the order of
+ * the map grid) whose ray goes through the given node, skipping the seeable tiles if asked to
+ * (see `g_vision_ray_is_seeable_arr`), or `INT_MAX` if there is none. */
+static int vision_ray_node_first_target(vision_octant_t const* octant, int node,
+	bool skips_seeable)
+{
+	int const k_begin = max(g_vision_ray_node_da[node].k, 2);
+	if (k_begin > octant->k_lim || octant->m_lim < 1)
+	{
+		return INT_MAX;
+	}
+	/* The rows of the map grid go along the minor axis if the major axis is x,
+	 * and along the major axis otherwise. The tiles of the node are in a cone that gets
+	 * wider with `K`, whose edges only go away from the axis. */
+	bool const rows_are_k = !octant->x_major;
+	int const row_sign = rows_are_k ? octant->major_sign : octant->minor_sign;
+	int const column_sign = rows_are_k ? octant->minor_sign : octant->major_sign;
+	int row_begin, row_end, lo, hi;
+	if (rows_are_k)
+	{
+		/* Not beyond where the cone leaves the map grid by its minor side. */
+		vision_ray_node_k_span(node, 1, &lo, &hi);
+		row_begin = max(k_begin, lo);
+		vision_ray_node_k_span(node, octant->m_lim, &lo, &hi);
+		row_end = min(hi, octant->k_lim);
+	}
+	else
+	{
+		vision_ray_node_m_span(node, k_begin, &lo, &hi);
+		row_begin = lo;
+		vision_ray_node_m_span(node, octant->k_lim, &lo, &hi);
+		row_end = min(hi, octant->m_lim);
+	}
+	for (int i = 0; i <= row_end - row_begin; i++)
+	{
+		int const row = row_sign > 0 ? row_begin + i : row_end - i;
+		int column_begin, column_end;
+		if (rows_are_k)
+		{
+			vision_ray_node_m_span(node, row, &column_begin, &column_end);
+			column_end = min(column_end, octant->m_lim);
+		}
+		else
+		{
+			vision_ray_node_k_span(node, row, &column_begin, &column_end);
+			column_end = min(column_end, octant->k_lim);
+		}
+		for (int j = 0; j <= column_end - column_begin; j++)
+		{
+			int const column = column_sign > 0 ? column_begin + j : column_end - j;
+			int const k = rows_are_k ? row : column, m = rows_are_k ? column : row;
+			if (!skips_seeable || !vision_ray_target_is_seeable(k, m))
+			{
+				return vision_octant_mg_index(octant, k, m);
+			}
+		}
+	}
+	return INT_MAX;
+}
+
+/* Adds a child to the given node (or the root if `parent` is -1) and returns it,
+ * or returns -1 if no ray would go there. */
+static int vision_ray_node_add(int parent, int child_index, int vision)
+{
+	vision_ray_node_t new_node = {
+		.k = 0, .m = 0, .parent = parent, .child_table = {-1, -1},
+		/* The tiles inside of the octant have `0 < M / K < 1`. */
+		.slope_lo_num = 0, .slope_lo_den = 1, .slope_hi_num = 1, .slope_hi_den = 1,
+		.vision = vision, .first_unseeable_target_index = INT_MAX};
+	if (parent >= 0)
+	{
+		vision_ray_node_t const* parent_node = &g_vision_ray_node_da[parent];
+		new_node.k = parent_node->k + 1;
+		new_node.m = parent_node->m + child_index;
+		int const lo_num = 2 * new_node.m - 1, hi_num = 2 * new_node.m + 1;
+		int const den = 2 * new_node.k;
+		bool const lo_is_greater =
+			lo_num * parent_node->slope_lo_den > parent_node->slope_lo_num * den;
+		new_node.slope_lo_num = lo_is_greater ? lo_num : parent_node->slope_lo_num;
+		new_node.slope_lo_den = lo_is_greater ? den : parent_node->slope_lo_den;
+		bool const hi_is_smaller =
+			hi_num * parent_node->slope_hi_den < parent_node->slope_hi_num * den;
+		new_node.slope_hi_num = hi_is_smaller ? hi_num : parent_node->slope_hi_num;
+		new_node.slope_hi_den = hi_is_smaller ? den : parent_node->slope_hi_den;
+		if (new_node.slope_lo_num * new_node.slope_hi_den >=
+			new_node.slope_hi_num * new_node.slope_lo_den)
+		{
+			return -1;
+		}
+	}
+	DA_LENGTHEN(g_vision_ray_node_da_len += 1, g_vision_ray_node_da_cap,
+		g_vision_ray_node_da, vision_ray_node_t);
+	int const node = g_vision_ray_node_da_len - 1;
+	g_vision_ray_node_da[node] = new_node;
+	if (parent >= 0)
+	{
+		g_vision_ray_node_da[parent].child_table[child_index] = node;
+	}
+	return node;
+}
+
+/* The node sees its tile (with the index of the ray that is cast). */
+static void vision_ray_node_see(vision_octant_t* octant, int node, int target_index)
+{
+	vision_ray_node_t* ray_node = &g_vision_ray_node_da[node];
+	if (!ray_node->is_seen)
+	{
+		ray_node->is_seen = true;
+		vision_octant_see(octant, target_index, ray_node->k, ray_node->m, ray_node->vision);
+	}
+}
+
+static int compare_vision_ray_events(void const* a, void const* b)
+{
+	vision_ray_event_t const* event_a = a;
+	vision_ray_event_t const* event_b = b;
+	if (event_a->target_index != event_b->target_index)
+	{
+		return (event_a->target_index > event_b->target_index) -
+			(event_a->target_index < event_b->target_index);
+	}
+	return (event_a->node > event_b->node) - (event_a->node < event_b->node);
+}
+
+/* Casts a ray to every tile inside of the octant that is not seen yet, in the order
+ * of the map grid, as if the rays to the tiles of the other octants were also cast.
+ * Only the tree of what can be seen is walked: the tiles that some ray can see (that are
+ * only around the source) are cast rays to one by one, and the rays to the tiles that no ray
+ * can see (that are always cast) are accounted for by the first of them to go through
+ * each node, so nothing farther than what can be seen is looked at. */
+static void vision_octant_compute(vision_octant_t* octant)
+{
+	/* The tiles inside of the octant were only seen by its own rays. */
+	for (int y = max(octant->y_min, 0); y <= min(octant->y_max, g_mg_rect.h - 1); y++)
+	{
+		int x_begin, x_end;
+		if (!vision_octant_row_span(octant, y, &x_begin, &x_end))
+		{
+			continue;
+		}
+		uint8_t* row = &g_mg_vision_arr[y * g_mg_rect.w];
+		for (int x = max(x_begin, octant->x_min); x < min(x_end, octant->x_max + 1); x++)
+		{
+			row[x] = 0;
+		}
+	}
+	vision_edge_clear(&octant->edge_table[0]);
+	vision_edge_clear(&octant->edge_table[1]);
+	octant->x_min = INT_MAX, octant->x_max = INT_MIN;
+	octant->y_min = INT_MAX, octant->y_max = INT_MIN;
+
+	int const src_major = octant->x_major ? g_vision_src_tc.x : g_vision_src_tc.y;
+	int const src_minor = octant->x_major ? g_vision_src_tc.y : g_vision_src_tc.x;
+	int const major_side = octant->x_major ? g_mg_rect.w : g_mg_rect.h;
+	int const minor_side = octant->x_major ? g_mg_rect.h : g_mg_rect.w;
+	octant->k_lim = octant->major_sign > 0 ? major_side - 1 - src_major : src_major;
+	octant->m_lim = octant->minor_sign > 0 ? minor_side - 1 - src_minor : src_minor;
+
+	/* The tree of what can be seen, the nodes being made in the order of their `k`.
+	 * A node that sees nothing gets no children, and a node that sees something only gets
+	 * the children that some ray to a tile of the map grid goes through (so that the tiles
+	 * of the nodes that see something are all in the map grid). */
+	g_vision_ray_node_da_len = 0;
+	g_vision_ray_event_da_len = 0;
+	vision_ray_node_add(-1, 0, VISION_SRC);
+	for (int node = 0; node < g_vision_ray_node_da_len; node++)
+	{
+		vision_ray_node_t const ray_node = g_vision_ray_node_da[node];
+		if (ray_node.vision == 0)
+		{
+			continue;
+		}
+		if (0 < ray_node.m && ray_node.m < ray_node.k)
+		{
+			int const index = vision_ray_target_index(ray_node.k, ray_node.m);
+			if (index >= g_vision_ray_is_seeable_arr_len)
+			{
+				int const new_len = vision_ray_target_index(ray_node.k + 1, ray_node.k) + 1;
+				g_vision_ray_is_seeable_arr =
+					realloc(g_vision_ray_is_seeable_arr, new_len * sizeof(bool));
+				assert(g_vision_ray_is_seeable_arr != NULL);
+				for (int i = g_vision_ray_is_seeable_arr_len; i < new_len; i++)
+				{
+					g_vision_ray_is_seeable_arr[i] = false;
+				}
+				g_vision_ray_is_seeable_arr_len = new_len;
+			}
+			if (!g_vision_ray_is_seeable_arr[index])
+			{
+				g_vision_ray_is_seeable_arr[index] = true;
+				DA_LENGTHEN(g_vision_ray_event_da_len += 1, g_vision_ray_event_da_cap,
+					g_vision_ray_event_da, vision_ray_event_t);
+				g_vision_ray_event_da[g_vision_ray_event_da_len-1] = (vision_ray_event_t){
+					.target_index = vision_octant_mg_index(octant, ray_node.k, ray_node.m),
+					.node = -1, .k = ray_node.k, .m = ray_node.m};
+			}
+		}
+		/* The source does not take anything away from the vision. */
+		int const child_vision = node == 0 ? ray_node.vision : max(0, ray_node.vision -
+			g_mg_vision_cost_arr[vision_octant_mg_index(octant, ray_node.k, ray_node.m)]);
+		for (int child_index = 0; child_index < 2; child_index++)
+		{
+			int const child = vision_ray_node_add(node, child_index, child_vision);
+			if (child >= 0 && child_vision > 0 &&
+				vision_ray_node_first_target(octant, child, false) == INT_MAX)
+			{
+				/* No ray to a tile of the map grid goes there. */
+				g_vision_ray_node_da[node].child_table[child_index] = -1;
+				g_vision_ray_node_da_len--;
+			}
+		}
+	}
+
+	/* The first tile that no ray can see of each node, from the leaves up (the children
+	 * being made after their parents). The tiles that some ray can see being only in the
+	 * tree, only the leaves have to look farther. */
+	for (int node = g_vision_ray_node_da_len - 1; node >= 0; node--)
+	{
+		vision_ray_node_t* ray_node = &g_vision_ray_node_da[node];
+		if (ray_node->vision == 0)
+		{
+			ray_node->first_unseeable_target_index =
+				vision_ray_node_first_target(octant, node, true);
+			continue;
+		}
+		for (int child_index = 0; child_index < 2; child_index++)
+		{
+			int const child = ray_node->child_table[child_index];
+			if (child >= 0)
+			{
+				ray_node->first_unseeable_target_index = min(ray_node->first_unseeable_target_index,
+					g_vision_ray_node_da[child].first_unseeable_target_index);
+			}
+		}
+	}
+
+	/* Then the rays are cast in the order of the map grid. */
+	for (int node = 1; node < g_vision_ray_node_da_len; node++)
+	{
+		vision_ray_node_t const* ray_node = &g_vision_ray_node_da[node];
+		if (ray_node->vision > 0 && ray_node->first_unseeable_target_index != INT_MAX)
+		{
+			DA_LENGTHEN(g_vision_ray_event_da_len += 1, g_vision_ray_event_da_cap,
+				g_vision_ray_event_da, vision_ray_event_t);
+			g_vision_ray_event_da[g_vision_ray_event_da_len-1] = (vision_ray_event_t){
+				.target_index = ray_node->first_unseeable_target_index, .node = node};
+		}
+	}
+	if (g_vision_ray_event_da_len > 1)
+	{
+		qsort(g_vision_ray_event_da, g_vision_ray_event_da_len, sizeof(vision_ray_event_t),
+			compare_vision_ray_events);
+	}
+	for (int i = 0; i < g_vision_ray_event_da_len; i++)
+	{
+		vision_ray_event_t const* event = &g_vision_ray_event_da[i];
+		if (event->node >= 0)
+		{
+			vision_ray_node_see(octant, event->node, event->target_index);
+			continue;
+		}
+		if (g_mg_vision_arr[event->target_index] != 0)
+		{
+			continue;
+		}
+		/* The nodes that the ray goes through are seen up to the last one that sees. */
+		int node = 0;
+		for (int j = 1; j <= event->k; j++)
+		{
+			int const m = (2 * j * event->m + event->k - 1) / (2 * event->k);
+			node = g_vision_ray_node_da[node].child_table[m - g_vision_ray_node_da[node].m];
+			assert(node >= 0);
+			if (g_vision_ray_node_da[node].vision == 0)
+			{
+				break;
+			}
+			vision_ray_node_see(octant, node, event->target_index);
+		}
+	}
+
+	for (int i = 0; i < g_vision_ray_event_da_len; i++)
+	{
+		vision_ray_event_t const* event = &g_vision_ray_event_da[i];
+		if (event->node < 0)
+		{
+			g_vision_ray_is_seeable_arr[vision_ray_target_index(event->k, event->m)] = false;
+		}
+	}
+	octant->is_dirty = false;
+}
+
+/* Casts the half-line as a ray to each of its tiles that is not seen yet (by the rays
+ * of the octants or by the ray of the half-line to an earlier tile) in the order
+ * of the map grid, and sets the vision of its tiles. */
+static void vision_half_line_compute(vision_half_line_t* half_line)
+{
+	tm_t const dir = half_line->dir;
+	int const src_index = g_vision_src_tc.y * g_mg_rect.w + g_vision_src_tc.x;
+	int const step_index = dir.y * g_mg_rect.w + dir.x;
+
+	/* Number of tiles of the half-line in the map grid. */
+	int len = INT_MAX;
+	len = dir.x > 0 ? min(len, g_mg_rect.w - 1 - g_vision_src_tc.x) : len;
+	len = dir.x < 0 ? min(len, g_vision_src_tc.x) : len;
+	len = dir.y > 0 ? min(len, g_mg_rect.h - 1 - g_vision_src_tc.y) : len;
+	len = dir.y < 0 ? min(len, g_vision_src_tc.y) : len;
+
+	/* The ray of the half-line, that is the same whatever tile it is cast to
+	 * (it just stops there), sees up to `dark_k`. */
+	int dark_k = 0;
+	int vision = VISION_SRC;
+	for (int k = 1; k <= len; k++)
+	{
+		g_vision_half_line_arr[k] = vision;
+		dark_k = k;
+		vision -= g_mg_vision_cost_arr[src_index + k * step_index];
+		if (vision <= 0)
+		{
+			break;
+		}
+	}
+
+	/* The ray to the tile `k` is cast if no earlier ray got there. Beyond the edges,
+	 * only the ray of the half-line can have got there, so the first ray cast there
+	 * (the one to the farthest tile if backward, else the one to the first tile beyond
+	 * the edges) lights it up to `dark_k` and the others do nothing more, which does not
+	 * require to go through these tiles (that go up to the side of the map grid). */
+	vision_edge_t const* edge_a = half_line->edge_table[0];
+	vision_edge_t const* edge_b = half_line->edge_table[1];
+	int const edge_len = max(edge_a->len, edge_b->len);
+	int const near_len = min(len, max(edge_len, 1) - 1);
+	int lit_k = 0;
+	bool const is_backward = step_index < 0;
+	if (is_backward && near_len < len)
+	{
+		lit_k = min(len, dark_k);
+	}
+	for (int i = 1; i <= near_len; i++)
+	{
+		int const k = is_backward ? near_len + 1 - i : i;
+		int const target_index = src_index + k * step_index;
+		bool const is_seen =
+			k <= lit_k ||
+			(k < edge_a->len && edge_a->first_target_index_arr[k] < target_index) ||
+			(k < edge_b->len && edge_b->first_target_index_arr[k] < target_index);
+		if (!is_seen)
+		{
+			lit_k = max(lit_k, min(k, dark_k));
+		}
+	}
+	if (!is_backward && near_len < len)
+	{
+		lit_k = max(lit_k, min(len, dark_k));
+	}
+
+	/* The vision of the tiles of the half-line is the best of the ray of the half-line and
+	 * of the edges (that are zero beyond their lengths), merged in place. */
+	int const new_len = max(lit_k + 1, max(min(edge_a->len, len + 1), min(edge_b->len, len + 1)));
+	int const merge_len = max(half_line->len, new_len);
+	int* merged_arr = g_vision_half_line_arr;
+	for (int k = 1; k < merge_len; k++)
+	{
+		int const vision = k <= lit_k ? merged_arr[k] : 0;
+		merged_arr[k] = max(vision, max(edge_a->vision_arr[k], edge_b->vision_arr[k]));
+	}
+	for (int k = 1; k < merge_len; k++)
+	{
+		g_mg_vision_arr[src_index + k * step_index] = merged_arr[k];
+	}
+	half_line->len = new_len;
+}
+
+void vision_compute(tc_t src_tc)
+{
+	bool const mg_changed = g_vision_mg_generation != g_mg_generation;
+	if (mg_changed)
+	{
+		vision_init();
+		g_vision_mg_generation = g_mg_generation;
+		g_vision_rect = (tc_rect_t){0, 0, 0, 0};
+	}
+
+	int const x_begin = max(g_vision_rect.x, 0);
+	int const y_begin = max(g_vision_rect.y, 0);
+	int const x_end = min(g_vision_rect.x + g_vision_rect.w, g_mg_rect.w);
+	int const y_end = min(g_vision_rect.y + g_vision_rect.h, g_mg_rect.h);
+	bool some_are_dirty = false;
+	if (mg_changed || !tc_eq(src_tc, g_vision_src_tc))
+	{
+		/* Everything is to be computed again. */
+		for (int y = y_begin; y < y_end; y++)
+		{
+			uint8_t* row = &g_mg_vision_arr[y * g_mg_rect.w];
+			uint8_t* dirty_row = &g_mg_vision_is_dirty_arr[y * g_mg_rect.w];
+			for (int x = x_begin; x < x_end; x++)
+			{
+				row[x] = 0;
+				dirty_row[x] = false;
+			}
+		}
+		for (int i = 0; i < 8; i++)
+		{
+			vision_octant_t* octant = &g_vision_octant_table[i];
+			octant->x_min = INT_MAX, octant->x_max = INT_MIN;
+			octant->y_min = INT_MAX, octant->y_max = INT_MIN;
+			octant->is_dirty = true;
+			g_vision_half_line_table[i].len = 0;
+		}
+		g_vision_src_tc = src_tc;
+		some_are_dirty = true;
+	}
+	else
+	{
+		/* Only the octants that see tiles that changed are to be computed again
+		 * (a tile that is not seen cannot change what is seen). */
+		for (int y = y_begin; y < y_end; y++)
+		{
+			/* Changes are rare, most rows have none. */
+			uint8_t* dirty_row = &g_mg_vision_is_dirty_arr[y * g_mg_rect.w];
+			uint8_t row_is_dirty = 0;
+			for (int x = x_begin; x < x_end; x++)
+			{
+				row_is_dirty |= dirty_row[x];
+			}
+			if (!row_is_dirty)
+			{
+				continue;
+			}
+			for (int x = x_begin; x < x_end; x++)
+			{
+				if (!dirty_row[x])
+				{
+					continue;
+				}
+				dirty_row[x] = false;
+				tc_t const tc = {x, y};
+				if (tc_eq(tc, src_tc))
+				{
+					/* The source does not take anything away from the vision. */
+					continue;
+				}
+				some_are_dirty = true;
+				int const octant_index = vision_octant_index_of(tc);
+				if (octant_index >= 0)
+				{
+					g_vision_octant_table[octant_index].is_dirty = true;
+					continue;
+				}
+				/* The rays of both octants on the sides of the half-line go through it. */
+				vision_half_line_t const* half_line =
+					&g_vision_half_line_table[vision_half_line_index_of(tc)];
+				g_vision_octant_table[half_line->octant_index_table[0]].is_dirty = true;
+				g_vision_octant_table[half_line->octant_index_table[1]].is_dirty = true;
+			}
+		}
+	}
+	if (!some_are_dirty)
+	{
+		/* Nothing that is seen changed, the vision is still the same. */
+		return;
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		if (g_vision_octant_table[i].is_dirty)
+		{
+			vision_octant_compute(&g_vision_octant_table[i]);
+		}
+	}
+	g_mg_vision_arr[src_tc.y * g_mg_rect.w + src_tc.x] = VISION_SRC;
+	for (int i = 0; i < 8; i++)
+	{
+		vision_half_line_compute(&g_vision_half_line_table[i]);
+	}
+
+	int x_min = src_tc.x, x_max = src_tc.x;
+	int y_min = src_tc.y, y_max = src_tc.y;
+	for (int i = 0; i < 8; i++)
+	{
+		vision_octant_t const* octant = &g_vision_octant_table[i];
+		x_min = min(x_min, octant->x_min);
+		x_max = max(x_max, octant->x_max);
+		y_min = min(y_min, octant->y_min);
+		y_max = max(y_max, octant->y_max);
+		vision_half_line_t const* half_line = &g_vision_half_line_table[i];
+		int const end_k = max(half_line->len - 1, 0);
+		tc_t const end_tc = {
+			src_tc.x + half_line->dir.x * end_k,
+			src_tc.y + half_line->dir.y * end_k};
+		x_min = min(x_min, end_tc.x);
+		x_max = max(x_max, end_tc.x);
+		y_min = min(y_min, end_tc.y);
+		y_max = max(y_max, end_tc.y);
+	}
+	g_vision_rect = (tc_rect_t){x_min, y_min, x_max - x_min + 1, y_max - y_min + 1};
+}
+
+/* Section dedicated to the vision of observers other than the player, that only see up
+ * to some distance and are all computed at once, one after the other in a small window
+ * around each of them. */
+
+/* Scratch buffer of the vision of the tiles of the window around an observer,
+ * shared by all the observers. */
+static uint8_t* g_vision_window_arr = NULL;
+static int g_vision_window_arr_cap = 0;
+
+/* Casts a ray to every tile of the window around `src_tc` that is not seen yet, in the order
+ * of the map grid, as `vision_compute` does on the whole map grid. */
+static void vision_window_compute(tc_t src_tc, tc_rect_t window)
+{
+	int const tile_number = window.w * window.h;
+	for (int i = 0; i < tile_number; i++)
+	{
+		g_vision_window_arr[i] = 0;
+	}
+	int const src_window_index = (src_tc.y - window.y) * window.w + (src_tc.x - window.x);
+	int const src_mg_index = src_tc.y * g_mg_rect.w + src_tc.x;
+	g_vision_window_arr[src_window_index] = VISION_SRC;
+
+	for (int y = window.y; y < window.y + window.h; y++)
+	for (int x = window.x; x < window.x + window.w; x++)
+	{
+		if (g_vision_window_arr[(y - window.y) * window.w + (x - window.x)] != 0)
+		{
+			continue;
+		}
+
+		/* The same steps as in `line_bresenham_iter`, and the ray stops once the vision
+		 * is all gone (as the rest of it would not see anything). */
+		int const dx = x - src_tc.x, dy = y - src_tc.y;
+		bool const x_major = abs(dy) < abs(dx);
+		int const major_len = x_major ? abs(dx) : abs(dy);
+		int const minor_len = x_major ? abs(dy) : abs(dx);
+		int const x_sign = dx > 0 ? 1 : -1, y_sign = dy > 0 ? 1 : -1;
+		int const major_window_step = x_major ? x_sign : y_sign * window.w;
+		int const minor_window_step = x_major ? y_sign * window.w : x_sign;
+		int const major_mg_step = x_major ? x_sign : y_sign * g_mg_rect.w;
+		int const minor_mg_step = x_major ? y_sign * g_mg_rect.w : x_sign;
+		int window_index = src_window_index, mg_index = src_mg_index;
+		int d = 2 * minor_len - major_len;
+		int vision = VISION_SRC;
+		for (int k = 1; k <= major_len; k++)
+		{
+			window_index += major_window_step;
+			mg_index += major_mg_step;
+			if (d > 0)
+			{
+				window_index += minor_window_step;
+				mg_index += minor_mg_step;
+				d += 2 * (minor_len - major_len);
+			}
+			else
+			{
+				d += 2 * minor_len;
+			}
+			g_vision_window_arr[window_index] = max(g_vision_window_arr[window_index], vision);
+			vision -= g_mg_vision_cost_arr[mg_index];
+			if (vision <= 0)
+			{
+				break;
+			}
+		}
+	}
+}
+
+void vision_compute_observers(vision_observer_t* observer_arr, int observer_number, int radius)
+{
+	int const side = 2 * radius + 1;
+	if (g_vision_window_arr_cap < side * side)
+	{
+		g_vision_window_arr_cap = side * side;
+		g_vision_window_arr = realloc(g_vision_window_arr, g_vision_window_arr_cap);
+		assert(g_vision_window_arr != NULL);
+	}
+
+	for (int i = 0; i < observer_number; i++)
+	{
+		vision_observer_t* observer = &observer_arr[i];
+		tc_t const src_tc = observer->src_tc, dst_tc = observer->dst_tc;
+		observer->vision = 0;
+		if (!tc_in_rect(src_tc, g_mg_rect) || !tc_in_rect(dst_tc, g_mg_rect) ||
+			abs(dst_tc.x - src_tc.x) > radius || abs(dst_tc.y - src_tc.y) > radius)
+		{
+			/* Too far to be seen, no need to look. */
+			continue;
+		}
+		int const x_begin = max(src_tc.x - radius, 0);
+		int const y_begin = max(src_tc.y - radius, 0);
+		int const x_end = min(src_tc.x + radius + 1, g_mg_rect.w);
+		int const y_end = min(src_tc.y + radius + 1, g_mg_rect.h);
+		tc_rect_t const window = {x_begin, y_begin, x_end - x_begin, y_end - y_begin};
+		vision_window_compute(src_tc, window);
+		observer->vision =
+			g_vision_window_arr[(dst_tc.y - window.y) * window.w + (dst_tc.x - window.x)];
+	}
+}
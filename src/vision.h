@@ -0,0 +1,38 @@
+
+#ifndef WHYCRYSTALS_HEADER_VISION_
+#define WHYCRYSTALS_HEADER_VISION_
+
+#include "tc.h"
+
+/* How well the source of vision sees its own tile, every tile after it along a ray
+ * taking its `vision_blocking_sum` away from what remains. */
+#define VISION_SRC 5
+
+/* Sets the vision of every tile of the map grid (in `g_mg_vision_arr`) to how well
+ * it is seen from `src_tc`.
+ * A Bresenham ray is cast from `src_tc` to every tile that is not seen yet (in the
+ * order of the map grid), each tile on the way being seen at least as well as what
+ * remains of the vision when the ray gets there.
+ * If `src_tc` is the same as the last time, then only the parts of the vision that see
+ * tiles that changed since then (see `g_mg_vision_is_dirty_arr`) are computed again,
+ * the vision being left as it is if there are none. */
+void vision_compute(tc_t src_tc);
+
+/* Something other than the player that sees from `src_tc` in the same way, but only
+ * up to some distance, and wants to know how well it sees `dst_tc`. */
+struct vision_observer_t
+{
+	tc_t src_tc;
+	tc_t dst_tc;
+	/* Set by `vision_compute_observers`, the vision that `dst_tc` would have. */
+	int vision;
+};
+typedef struct vision_observer_t vision_observer_t;
+
+/* Computes the vision of all the given observers at once, each seeing like `vision_compute`
+ * would from its `src_tc` but only casting rays to the tiles that are at most `radius` tiles
+ * away along both axes (a `dst_tc` farther than that is not seen at all). This does not
+ * touch `g_mg_vision_arr`, and all the observers share the same small buffer. */
+void vision_compute_observers(vision_observer_t* observer_arr, int observer_number, int radius);
+
+#endif /* WHYCRYSTALS_HEADER_VISION_ */